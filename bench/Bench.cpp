@@ -0,0 +1,366 @@
+//
+//  Bench.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "simdhash.h"
+
+#include "Common.hpp"
+#include "CpuFeatures.hpp"
+#include "CrackList.hpp"
+#include "HashList.hpp"
+#include "Util.hpp"
+
+// Candidates hashed per algorithm
+#define HASH_OPERATIONS (1 << 22)
+// Linear lookups are only timed on lists up to this size
+#define LINEAR_MAX_COUNT (65536)
+#define LINEAR_QUERIES (4096)
+// Lines parsed by the wordlist parsing benchmark
+#define PARSE_LINES (1 << 21)
+
+// Results are folded in here and printed at the end so
+// no benchmark can be optimised away
+static uint64_t s_Sink = 0;
+
+template<typename Function>
+static void
+Measure(
+    const std::string& Name,
+    const size_t Operations,
+    Function&& Body
+)
+{
+    auto start = std::chrono::steady_clock::now();
+    Body();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    const double nsPerOp = Operations ? (double)elapsed / Operations : 0;
+    const double opsPerSec = elapsed ? (double)Operations * 1000000000 / elapsed : 0;
+    std::string factor;
+    const double scaled = Util::NumFactor(opsPerSec, factor);
+    printf("%-44s %10.2f ns/op %10.2f%s ops/s\n", Name.c_str(), nsPerOp, scaled, factor.c_str());
+    fflush(stdout);
+}
+
+static std::vector<std::string>
+RandomWords(
+    std::mt19937_64& Random,
+    const size_t Count,
+    const size_t MinLength,
+    const size_t MaxLength
+)
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%";
+    std::uniform_int_distribution<size_t> length(MinLength, MaxLength);
+    std::uniform_int_distribution<size_t> character(0, sizeof(alphabet) - 2);
+    std::vector<std::string> words(Count);
+    for (auto& word : words)
+    {
+        word.resize(length(Random));
+        for (auto& c : word)
+        {
+            c = alphabet[character(Random)];
+        }
+    }
+    return words;
+}
+
+// Count sorted random digests of DigestLength bytes
+static std::vector<uint8_t>
+RandomDigests(
+    std::mt19937_64& Random,
+    const size_t Count,
+    const size_t DigestLength
+)
+{
+    std::vector<uint8_t> digests(Count * DigestLength);
+    for (size_t i = 0; i < digests.size(); i += sizeof(uint64_t))
+    {
+        const uint64_t value = Random();
+        memcpy(&digests[i], &value, std::min(sizeof(uint64_t), digests.size() - i));
+    }
+    HashList::Sort(&digests[0], Count, DigestLength);
+    return digests;
+}
+
+static std::vector<size_t>
+ParseList(
+    const std::string& List
+)
+{
+    std::vector<size_t> values;
+    std::stringstream stream(List);
+    std::string value;
+    while (std::getline(stream, value, ','))
+    {
+        values.push_back(std::stoull(value));
+    }
+    return values;
+}
+
+static void
+BenchHashing(
+    std::mt19937_64& Random
+)
+{
+    const size_t lanes = CpuFeatures::Lanes();
+    auto words = RandomWords(Random, 4096, 6, 16);
+    std::array<uint8_t, MAX_HASH_SIZE * CPU_MAX_LANES> hashes;
+    SimdLaneBuffer<64> buffer;
+
+    for (auto algorithm : {HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256, HashAlgorithmNTLM})
+    {
+        const std::string name = HashAlgorithmToString(algorithm);
+
+        Measure("SimdHash " + name + " x" + std::to_string(lanes), HASH_OPERATIONS, [&]{
+            for (size_t i = 0; i < HASH_OPERATIONS; i += lanes)
+            {
+                for (size_t h = 0; h < lanes; h++)
+                {
+                    buffer.Set(h, words[(i + h) % words.size()]);
+                }
+                CpuFeatures::Hash(algorithm, buffer.GetLengths(), buffer.ConstBuffers(), &hashes[0]);
+                s_Sink += hashes[0];
+            }
+        });
+
+        Measure("DoHash " + name + " scalar", HASH_OPERATIONS / 8, [&]{
+            for (size_t i = 0; i < HASH_OPERATIONS / 8; i++)
+            {
+                const std::string& word = words[i % words.size()];
+                DoHash(algorithm, (const uint8_t*)word.data(), word.size(), &hashes[0]);
+                s_Sink += hashes[0];
+            }
+        });
+    }
+}
+
+static void
+BenchLookup(
+    std::mt19937_64& Random,
+    const std::vector<size_t>& Sizes,
+    const std::vector<size_t>& Bitmasks,
+    const size_t Queries
+)
+{
+    const size_t digestLength = 20;
+
+    for (const size_t count : Sizes)
+    {
+        auto digests = RandomDigests(Random, count, digestLength);
+
+        // Roughly half of the queries are present in the list
+        std::vector<uint8_t> queries = RandomDigests(Random, Queries, digestLength);
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+        for (size_t i = 0; i < Queries; i++)
+        {
+            if (Random() & 1)
+            {
+                memcpy(&queries[i * digestLength], &digests[pick(Random) * digestLength], digestLength);
+            }
+        }
+
+        const std::string suffix = " n=" + std::to_string(count);
+
+        HashList plain;
+        if (!plain.Initialize(&digests[0], digests.size(), digestLength, false))
+        {
+            continue;
+        }
+
+        if (count <= LINEAR_MAX_COUNT)
+        {
+            const size_t linearQueries = std::min<size_t>(Queries, LINEAR_QUERIES);
+            Measure("HashList::LookupLinear" + suffix, linearQueries, [&]{
+                for (size_t i = 0; i < linearQueries; i++)
+                {
+                    s_Sink += plain.LookupLinear(&queries[i * digestLength]);
+                }
+            });
+        }
+
+        Measure("HashList::LookupBinary" + suffix, Queries, [&]{
+            for (size_t i = 0; i < Queries; i++)
+            {
+                s_Sink += plain.LookupBinary(&queries[i * digestLength]);
+            }
+        });
+
+        // The bucket index is only built from FAST_LOOKUP_THRESHOLD
+        for (const size_t bitmask : Bitmasks)
+        {
+            if (count < FAST_LOOKUP_THRESHOLD)
+            {
+                break;
+            }
+
+            HashList indexed;
+            indexed.SetBitmaskSize(bitmask);
+            if (!indexed.Initialize(&digests[0], digests.size(), digestLength, false))
+            {
+                continue;
+            }
+            Measure("HashList::LookupFast" + suffix + " bits=" + std::to_string(indexed.GetBitmaskSize()), Queries, [&]{
+                for (size_t i = 0; i < Queries; i++)
+                {
+                    s_Sink += indexed.LookupFast(&queries[i * digestLength]);
+                }
+            });
+        }
+
+        HashList compressed;
+        compressed.SetCompressed(true);
+        if (compressed.Initialize(&digests[0], digests.size(), digestLength, false))
+        {
+            Measure("HashList::LookupCompressed" + suffix, Queries, [&]{
+                for (size_t i = 0; i < Queries; i++)
+                {
+                    s_Sink += compressed.LookupCompressed(&queries[i * digestLength]);
+                }
+            });
+        }
+    }
+}
+
+static void
+BenchParsing(
+    std::mt19937_64& Random
+)
+{
+    auto words = RandomWords(Random, PARSE_LINES, 4, 24);
+
+    // One in sixteen lines is $HEX[] encoded and one in
+    // eight has a Windows line ending
+    std::string text;
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        if (i % 16 == 0)
+        {
+            text += "$HEX[" + Util::ToHex((const uint8_t*)words[i].data(), words[i].size()) + "]";
+        }
+        else
+        {
+            text += words[i];
+        }
+        text += i % 8 == 0 ? "\r\n" : "\n";
+    }
+
+    CrackList cracklist;
+    cracklist.SetParseHexInput(true);
+    Measure("ReadBlock getline + ParseWord", words.size(), [&]{
+        std::istringstream input(text);
+        std::string line;
+        while (std::getline(input, line))
+        {
+            if (cracklist.ParseWord(line))
+            {
+                s_Sink += line.size();
+            }
+        }
+    });
+
+    std::vector<std::string> hex;
+    for (size_t i = 0; i < 65536; i++)
+    {
+        hex.push_back(Util::ToHex((const uint8_t*)words[i].data(), words[i].size()));
+    }
+
+    Measure("Util::ParseHex", PARSE_LINES, [&]{
+        for (size_t i = 0; i < PARSE_LINES; i++)
+        {
+            s_Sink += Util::ParseHex(hex[i % hex.size()]).size();
+        }
+    });
+
+    std::array<uint8_t, 32> digest;
+    std::generate(digest.begin(), digest.end(), [&]{ return (uint8_t)Random(); });
+    char output[digest.size() * 2];
+    Measure("Util::ToHex 20 bytes", PARSE_LINES, [&]{
+        for (size_t i = 0; i < PARSE_LINES; i++)
+        {
+            digest[0] = (uint8_t)i;
+            Util::ToHex(&digest[0], 20, output);
+            s_Sink += output[0];
+        }
+    });
+}
+
+int
+main(
+    int argc,
+    const char * argv[]
+)
+{
+    std::vector<size_t> sizes = {1000, 1000000, 10000000};
+    // Zero picks the size CrackList would use for the list
+    std::vector<size_t> bitmasks = {0, 16, 20, 24};
+    size_t queries = 1000000;
+    uint64_t seed = 1;
+    bool hashing = true;
+    bool lookup = true;
+    bool parsing = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--sizes" && i + 1 < argc)
+        {
+            sizes = ParseList(argv[++i]);
+        }
+        else if (arg == "--bitmasks" && i + 1 < argc)
+        {
+            bitmasks = ParseList(argv[++i]);
+        }
+        else if (arg == "--queries" && i + 1 < argc)
+        {
+            queries = std::max<size_t>(std::stoull(argv[++i]), 2);
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--only" && i + 1 < argc)
+        {
+            const std::string only = argv[++i];
+            hashing = only == "hash";
+            lookup = only == "lookup";
+            parsing = only == "parse";
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--sizes N,N] [--bitmasks B,B] [--queries N] [--seed N] [--only hash|lookup|parse]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937_64 random(seed);
+
+    if (hashing)
+    {
+        BenchHashing(random);
+    }
+    if (lookup)
+    {
+        BenchLookup(random, sizes, bitmasks, queries);
+    }
+    if (parsing)
+    {
+        BenchParsing(random);
+    }
+
+    std::cerr << "Checksum " << s_Sink << std::endl;
+    return 0;
+}
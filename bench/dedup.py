@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+#
+#  dedup.py
+#  CrackList
+#
+#  Created by Kryc on 19/10/2026.
+#  Copyright © 2026 Kryc. All rights reserved.
+#
+#  Measures the duplicate filter. Generates a dataset with
+#  "cracklist generate", builds a wordlist that repeats its words
+#  file a number of times and cracks it with and without --dedup,
+#  checking both produce the expected hits.
+#
+#    bench/dedup.py --cracklist build/cracklist
+#    bench/dedup.py --cracklist build/cracklist --targets 1000000 --repeats 14
+#
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+SEED = 20261019
+
+
+def crack(cracklist, directory, wordlist, extra):
+    output = os.path.join(directory, "out.txt")
+    if os.path.exists(output):
+        os.unlink(output)
+
+    command = [cracklist, "--sha1"] + extra + ["-o", output, os.path.join(directory, "targets.txt"), wordlist]
+    start = time.monotonic()
+    process = subprocess.run(command, stderr=subprocess.PIPE, check=True)
+    wall = time.monotonic() - start
+
+    with open(output) as cracked, open(os.path.join(directory, "expected.txt")) as expected:
+        correct = sorted(set(cracked.read().splitlines())) == sorted(expected.read().splitlines())
+
+    skipped = ""
+    for line in process.stderr.decode(errors="replace").splitlines():
+        if line.startswith("Skipped"):
+            skipped = " ".join(line.split())
+    return wall, correct, skipped
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CrackList duplicate filter benchmark")
+    parser.add_argument("--cracklist", default="cracklist", help="path to the cracklist binary")
+    parser.add_argument("--work", default="dedup-data", help="where the dataset is generated and kept")
+    parser.add_argument("--targets", type=int, default=1000000)
+    parser.add_argument("--repeats", type=int, default=14, help="times the words file is repeated")
+    parser.add_argument("--memory", type=int, default=256, help="--dedup budget in MB")
+    parser.add_argument("--threads", default="0")
+    args = parser.parse_args()
+
+    directory = os.path.join(args.work, str(args.targets))
+    if not os.path.exists(os.path.join(directory, "expected.txt")):
+        subprocess.run(
+            [args.cracklist, "generate", "--sha1", "--seed", str(SEED), "--targets", str(args.targets), "-o", directory],
+            check=True,
+        )
+
+    wordlist = os.path.join(directory, "words-x%d.txt" % args.repeats)
+    if not os.path.exists(wordlist):
+        with open(os.path.join(directory, "words.txt"), "rb") as f:
+            words = f.read()
+        with open(wordlist, "wb") as f:
+            for _ in range(args.repeats):
+                f.write(words)
+
+    failures = 0
+    for name, extra in (("plain", []), ("dedup", ["--dedup", str(args.memory)])):
+        wall, correct, skipped = crack(args.cracklist, directory, wordlist, ["-t", args.threads] + extra)
+        print("%-6s correct=%s wall=%.3fs %s" % (name, correct, wall, skipped))
+        failures += 0 if correct else 1
+
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+#
+#  regress.py
+#  CrackList
+#
+#  Created by Kryc on 19/10/2026.
+#  Copyright © 2026 Kryc. All rights reserved.
+#
+#  End to end regression check. Generates reproducible datasets with
+#  "cracklist generate", cracks them in linear and threaded mode and
+#  checks the cracked set, also through a --serve daemon and
+#  "cracklist submit". With --check-perf the wall time, peak RSS and
+#  startup time are compared against a stored baseline, which is only
+#  meaningful on the machine it was recorded on.
+#
+#    bench/regress.py --cracklist build/cracklist --scales 1k,1m
+#    bench/regress.py --cracklist build/cracklist --check-perf
+#    bench/regress.py --cracklist build/cracklist --update
+#
+#  ctest runs the correctness check at the 1k scale.
+#
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+# How long to wait for a daemon to load the hash list and listen
+SERVE_TIMEOUT_S = 600
+
+SCALES = {"1k": 1000, "1m": 1000000}
+MODES = {"linear": ["-t", "1"], "threaded": ["-t", "0"]}
+SEED = 20261019
+
+# Absolute slack so that very short runs do not fail on noise
+SLACK = {"wall_s": 0.05, "startup_s": 0.05, "rss_mb": 8}
+
+
+def generate(cracklist, work, scale):
+    directory = os.path.join(work, scale)
+    if os.path.exists(os.path.join(directory, "expected.txt")):
+        return directory
+    subprocess.run(
+        [cracklist, "generate", "--sha1", "--seed", str(SEED), "--targets", str(SCALES[scale]), "-o", directory],
+        check=True,
+    )
+    return directory
+
+
+def run(cracklist, directory, mode):
+    output = os.path.join(directory, "out-%s.txt" % mode)
+    if os.path.exists(output):
+        os.unlink(output)
+
+    command = [cracklist, "--sha1"] + MODES[mode] + ["-o", output, os.path.join(directory, "targets.txt"), os.path.join(directory, "words.txt")]
+    start = time.monotonic()
+    startup = None
+    process = subprocess.Popen(command, stderr=subprocess.PIPE)
+    # Startup is the time until the hash list is loaded and indexed
+    for line in process.stderr:
+        if startup is None and b"Beginning cracking" in line:
+            startup = time.monotonic() - start
+    _, status, usage = os.wait4(process.pid, 0)
+    wall = time.monotonic() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+
+    if process.returncode != 0:
+        raise RuntimeError("%s exited with %d" % (" ".join(command), process.returncode))
+
+    with open(output) as cracked, open(os.path.join(directory, "expected.txt")) as expected:
+        correct = sorted(cracked.read().splitlines()) == sorted(expected.read().splitlines())
+
+    return {
+        "correct": correct,
+        "wall_s": round(wall, 3),
+        "startup_s": round(startup or wall, 3),
+        # ru_maxrss is in KB on Linux
+        "rss_mb": round(usage.ru_maxrss / 1024, 1),
+    }
+
+
+def expected_matches(output, directory):
+    with open(output) as cracked, open(os.path.join(directory, "expected.txt")) as expected:
+        return sorted(set(cracked.read().splitlines())) == sorted(expected.read().splitlines())
+
+
+def serve(cracklist, directory):
+    socket = os.path.join(directory, "serve.sock")
+    output = os.path.join(directory, "out-served.txt")
+    for path in (socket, output):
+        if os.path.exists(path):
+            os.unlink(path)
+
+    server = subprocess.Popen([cracklist, "--sha1", "--serve", socket, os.path.join(directory, "targets.txt")], stderr=subprocess.DEVNULL)
+    try:
+        deadline = time.monotonic() + SERVE_TIMEOUT_S
+        while not os.path.exists(socket):
+            if server.poll() is not None or time.monotonic() > deadline:
+                raise RuntimeError("cracklist --serve did not start listening on " + socket)
+            time.sleep(0.1)
+
+        subprocess.run(
+            [cracklist, "submit", socket, os.path.join(directory, "words.txt"), "-o", output],
+            stderr=subprocess.DEVNULL,
+            check=True,
+        )
+        return expected_matches(output, directory)
+    finally:
+        server.terminate()
+        server.wait()
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="CrackList end to end regression check")
+    parser.add_argument("--cracklist", default="cracklist", help="path to the cracklist binary")
+    parser.add_argument("--baseline", default=os.path.join(here, "baseline.json"))
+    parser.add_argument("--work", default="regress-data", help="where datasets are generated and kept")
+    parser.add_argument("--scales", default="1k,1m", help="comma separated subset of " + ",".join(SCALES))
+    parser.add_argument("--check-perf", action="store_true", help="compare timings and memory against the baseline")
+    parser.add_argument("--update", action="store_true", help="record the measured values as the new baseline")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    tolerance = baseline["tolerance"]
+    runs = baseline.setdefault("runs", {})
+
+    failures = []
+    for scale in args.scales.split(","):
+        directory = generate(args.cracklist, args.work, scale)
+        for mode in MODES:
+            name = "%s/%s" % (scale, mode)
+            result = run(args.cracklist, directory, mode)
+            print("%-14s correct=%s wall=%.3fs startup=%.3fs rss=%.1fMB" % (
+                name, result["correct"], result["wall_s"], result["startup_s"], result["rss_mb"]))
+
+            if not result["correct"]:
+                failures.append("%s: cracked set differs from expected.txt" % name)
+
+            if args.update:
+                runs[name] = {key: result[key] for key in SLACK}
+                continue
+
+            if not args.check_perf:
+                continue
+
+            if name not in runs:
+                print("%-14s no baseline, run with --update to record one" % name)
+                continue
+
+            for key in SLACK:
+                limit = runs[name][key] * (1 + tolerance[key]) + SLACK[key]
+                if result[key] > limit:
+                    failures.append("%s: %s %.3f exceeds baseline %.3f (limit %.3f)" % (
+                        name, key, result[key], runs[name][key], limit))
+
+        # Only the cracked set is checked through the daemon
+        name = "%s/served" % scale
+        correct = serve(args.cracklist, directory)
+        print("%-14s correct=%s" % (name, correct))
+        if not correct:
+            failures.append("%s: cracked set differs from expected.txt" % name)
+
+    if args.update:
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=4, sort_keys=True)
+            f.write("\n")
+        print("Updated " + args.baseline)
+
+    for failure in failures:
+        print("FAIL " + failure)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,49 @@
+#
+#  PrefixSymbols.cmake
+#  CrackList
+#
+#  Created by Kryc on 19/10/2026.
+#  Copyright © 2026 Kryc. All rights reserved.
+#
+#  Copies the static library INPUT to OUTPUT with PREFIX added to
+#  every global symbol it defines, so builds of the same sources for
+#  different ISA levels can be linked into one binary.
+#
+#    cmake -DNM=nm -DOBJCOPY=objcopy -DPREFIX=avx2_ -DINPUT=in.a -DOUTPUT=out.a -P PrefixSymbols.cmake
+#
+
+execute_process(
+    COMMAND ${NM} --defined-only --extern-only --format=posix ${INPUT}
+    OUTPUT_VARIABLE SYMBOLS
+    RESULT_VARIABLE RESULT
+)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Unable to list the symbols of ${INPUT}")
+endif()
+
+# Lines are "name type value size", member headers end in a colon
+string(REPLACE "\n" ";" LINES "${SYMBOLS}")
+set(NAMES "")
+foreach(LINE ${LINES})
+    if(LINE MATCHES "^([^ ]+) [A-Za-z]( |$)")
+        list(APPEND NAMES ${CMAKE_MATCH_1})
+    endif()
+endforeach()
+# Weak symbols are defined by more than one member
+if(NAMES)
+    list(REMOVE_DUPLICATES NAMES)
+endif()
+
+set(MAP "")
+foreach(NAME ${NAMES})
+    string(APPEND MAP "${NAME} ${PREFIX}${NAME}\n")
+endforeach()
+file(WRITE ${OUTPUT}.syms "${MAP}")
+
+execute_process(
+    COMMAND ${OBJCOPY} --redefine-syms=${OUTPUT}.syms ${INPUT} ${OUTPUT}
+    RESULT_VARIABLE RESULT
+)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Unable to prefix the symbols of ${INPUT}")
+endif()
@@ -0,0 +1,49 @@
+//
+//  AtomicBitmap.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef AtomicBitmap_hpp
+#define AtomicBitmap_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+//
+// Fixed size bitmap that can be set concurrently from any thread
+//
+class AtomicBitmap
+{
+public:
+    AtomicBitmap(const size_t Size) : m_Size(Size), m_Words((Size + 63) / 64) {};
+    // Returns true only for the caller that changed the bit
+    const bool Set(const size_t Index)
+    {
+        const uint64_t bit = 1ull << (Index % 64);
+        std::atomic<uint64_t>& word = m_Words[Index / 64];
+        // Avoid dirtying the cache line if it is already set
+        if (word.load(std::memory_order_relaxed) & bit)
+        {
+            return false;
+        }
+        return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    };
+    const bool Test(const size_t Index) const
+    {
+        return m_Words[Index / 64].load(std::memory_order_relaxed) & (1ull << (Index % 64));
+    };
+    const size_t GetSize(void) const { return m_Size; };
+    // Raw word access for persisting the bitmap
+    const size_t GetWordCount(void) const { return m_Words.size(); };
+    const uint64_t GetWord(const size_t Index) const { return m_Words[Index].load(std::memory_order_relaxed); };
+    void SetWord(const size_t Index, const uint64_t Value) { m_Words[Index].store(Value, std::memory_order_relaxed); };
+private:
+    size_t m_Size;
+    std::vector<std::atomic<uint64_t>> m_Words;
+};
+
+#endif //AtomicBitmap_hpp
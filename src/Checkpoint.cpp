@@ -0,0 +1,187 @@
+//
+//  Checkpoint.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "Checkpoint.hpp"
+
+void
+Checkpoint::Start(
+    const uint64_t Offset,
+    const uint64_t Words
+)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_NextSequence = 0;
+    m_Offset = Offset;
+    m_Words = Words;
+    m_Pending.clear();
+}
+
+void
+Checkpoint::Complete(
+    const size_t Sequence,
+    const uint64_t End,
+    const uint64_t Words
+)
+{
+    // Nothing reads the watermark unless it is being saved
+    if (m_Path.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pending[Sequence] = {End, Words};
+
+    // Advance over every block that is now contiguous
+    auto next = m_Pending.begin();
+    while (next != m_Pending.end() && next->first == m_NextSequence)
+    {
+        m_Offset = next->second.first;
+        m_Words += next->second.second;
+        m_NextSequence++;
+        next = m_Pending.erase(next);
+    }
+}
+
+const bool
+Checkpoint::Due(
+    void
+) const
+{
+    return !m_Path.empty() &&
+        std::chrono::steady_clock::now() - m_LastSave >= std::chrono::seconds(m_Interval);
+}
+
+const bool
+Checkpoint::Save(
+    const AtomicBitmap& Cracked
+)
+{
+    CheckpointHeader header;
+    memcpy(header.Magic, CHECKPOINT_MAGIC, sizeof(header.Magic));
+    header.Version = CHECKPOINT_VERSION;
+    header.ConfigHash = m_ConfigHash;
+    header.BitmapSize = Cracked.GetSize();
+    header.HashFileOffset = m_HashFileOffset;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        header.Offset = m_Offset;
+        header.Words = m_Words;
+    }
+
+    std::vector<uint64_t> words(Cracked.GetWordCount());
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        words[i] = Cracked.GetWord(i);
+    }
+
+    // Write beside the old checkpoint and swap it in so an
+    // interrupted save never loses the previous one
+    const std::filesystem::path temp = m_Path.string() + ".tmp";
+    FILE* handle = fopen(temp.c_str(), "wb");
+    if (handle == nullptr)
+    {
+        std::cerr << "Error: unable to open " << temp << " for writing" << std::endl;
+        return false;
+    }
+
+    bool success = fwrite(&header, sizeof(header), 1, handle) == 1;
+    success = success && (words.empty() || fwrite(&words[0], sizeof(uint64_t), words.size(), handle) == words.size());
+    success = fflush(handle) == 0 && success;
+    success = fsync(fileno(handle)) == 0 && success;
+    success = fclose(handle) == 0 && success;
+
+    std::error_code error;
+    if (success)
+    {
+        std::filesystem::rename(temp, m_Path, error);
+    }
+
+    if (!success || error)
+    {
+        std::cerr << "Error: failed writing checkpoint " << m_Path << std::endl;
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+
+    m_LastSave = std::chrono::steady_clock::now();
+    return true;
+}
+
+const bool
+Checkpoint::Load(
+    AtomicBitmap& Cracked
+)
+{
+    FILE* handle = fopen(m_Path.c_str(), "rb");
+    if (handle == nullptr)
+    {
+        std::cerr << "Error: unable to open checkpoint " << m_Path << std::endl;
+        return false;
+    }
+
+    CheckpointHeader header;
+    std::vector<uint64_t> words(Cracked.GetWordCount());
+    bool success = fread(&header, sizeof(header), 1, handle) == 1 &&
+        memcmp(header.Magic, CHECKPOINT_MAGIC, sizeof(header.Magic)) == 0 &&
+        header.Version == CHECKPOINT_VERSION;
+
+    if (!success)
+    {
+        std::cerr << "Error: " << m_Path << " is not a checkpoint" << std::endl;
+    }
+    else if (header.ConfigHash != m_ConfigHash || header.BitmapSize != Cracked.GetSize())
+    {
+        std::cerr << "Error: checkpoint " << m_Path << " was written for a different hash list, wordlist or configuration" << std::endl;
+        success = false;
+    }
+    else if (!words.empty() && fread(&words[0], sizeof(uint64_t), words.size(), handle) != words.size())
+    {
+        std::cerr << "Error: checkpoint " << m_Path << " is truncated" << std::endl;
+        success = false;
+    }
+
+    fclose(handle);
+
+    if (!success)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        Cracked.SetWord(i, words[i]);
+    }
+
+    Start(header.Offset, header.Words);
+    return true;
+}
+
+const bool
+Checkpoint::ReadHeader(
+    CheckpointHeader& Header
+) const
+{
+    FILE* handle = fopen(m_Path.c_str(), "rb");
+    if (handle == nullptr)
+    {
+        return false;
+    }
+
+    const bool success = fread(&Header, sizeof(Header), 1, handle) == 1 &&
+        memcmp(Header.Magic, CHECKPOINT_MAGIC, sizeof(Header.Magic)) == 0 &&
+        Header.Version == CHECKPOINT_VERSION;
+    fclose(handle);
+    return success;
+}
@@ -0,0 +1,77 @@
+//
+//  Checkpoint.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef Checkpoint_hpp
+#define Checkpoint_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "AtomicBitmap.hpp"
+
+typedef struct __attribute__((packed)) _CheckpointHeader
+{
+    char Magic[4];
+    uint32_t Version;
+    uint64_t ConfigHash;
+    uint64_t Offset;
+    uint64_t Words;
+    uint64_t BitmapSize;
+    uint64_t HashFileOffset;
+} CheckpointHeader;
+
+#define CHECKPOINT_MAGIC "CLCP"
+#define CHECKPOINT_VERSION (2)
+
+//
+// Tracks how far through the wordlist every block has been
+// processed. Blocks complete out of order, so the saved offset is
+// the end of the last block of the contiguous completed prefix.
+//
+class Checkpoint
+{
+public:
+    Checkpoint(void) = default;
+    void SetPath(const std::filesystem::path Path) { m_Path = Path; }
+    void SetInterval(const size_t Seconds) { m_Interval = Seconds; }
+    void SetConfigHash(const uint64_t ConfigHash) { m_ConfigHash = ConfigHash; }
+    // Bytes of the hash file loaded into the main list, which may
+    // have grown since when it is being watched
+    void SetHashFileOffset(const uint64_t HashFileOffset) { m_HashFileOffset = HashFileOffset; }
+    const uint64_t GetHashFileOffset(void) const { return m_HashFileOffset; }
+    const std::filesystem::path GetPath(void) const { return m_Path; }
+    const uint64_t GetOffset(void) const { return m_Offset; }
+    const uint64_t GetWords(void) const { return m_Words; }
+    // Resets the watermark to Offset with no blocks issued
+    void Start(const uint64_t Offset, const uint64_t Words);
+    // Marks block Sequence, ending at byte End, as fully processed
+    void Complete(const size_t Sequence, const uint64_t End, const uint64_t Words);
+    const bool Due(void) const;
+    const bool Save(const AtomicBitmap& Cracked);
+    const bool Load(AtomicBitmap& Cracked);
+    // Reads only the header, to size the hash list before Load
+    const bool ReadHeader(CheckpointHeader& Header) const;
+private:
+    std::filesystem::path m_Path;
+    size_t m_Interval = 60;
+    uint64_t m_ConfigHash = 0;
+    uint64_t m_HashFileOffset = 0;
+    mutable std::mutex m_Mutex;
+    size_t m_NextSequence = 0;
+    uint64_t m_Offset = 0;
+    uint64_t m_Words = 0;
+    // Completed blocks waiting on an earlier one
+    std::map<size_t, std::pair<uint64_t, uint64_t>> m_Pending;
+    std::chrono::steady_clock::time_point m_LastSave = std::chrono::steady_clock::now();
+};
+
+#endif //Checkpoint_hpp
@@ -9,6 +9,7 @@
 #ifndef Common_hpp
 #define Common_hpp
 
+#include <openssl/md4.h>
 #include <openssl/md5.h>
 #include <openssl/sha.h>
 #include <string>
@@ -35,9 +36,35 @@ DoHash(
         case HashAlgorithmSHA256:
             SHA256(Data, Length, Digest);
             break;
+        case HashAlgorithmMD4:
+            MD4(Data, Length, Digest);
+            break;
+        case HashAlgorithmNTLM:
+        {
+            // MD4 of the little endian UTF-16 widening of the input
+            std::vector<uint8_t> wide(Length * 2);
+            for (size_t i = 0; i < Length; i++)
+            {
+                wide[i * 2] = Data[i];
+            }
+            MD4(wide.data(), wide.size(), Digest);
+            break;
+        }
         default:
             break;
     }
 }
 
+// Number of 64 byte compression blocks needed for Length bytes
+// of input, including the padding and length suffix
+inline const size_t
+CompressionBlocks(
+    const HashAlgorithm Algorithm,
+    const size_t Length
+)
+{
+    const size_t bytes = Algorithm == HashAlgorithmNTLM ? Length * 2 : Length;
+    return (bytes + 8) / 64 + 1;
+}
+
 #endif /* Common_hpp */
\ No newline at end of file
@@ -0,0 +1,117 @@
+//
+//  CompiledWordlist.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <algorithm>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "CompiledWordlist.hpp"
+
+const bool
+CompiledWordlist::IsCompiled(
+    const std::filesystem::path Path
+)
+{
+    char magic[4] = {0};
+    std::ifstream input(Path, std::ios::in | std::ios::binary);
+    input.read(magic, sizeof(magic));
+    return input.gcount() == sizeof(magic) && memcmp(magic, WORDLIST_MAGIC, sizeof(magic)) == 0;
+}
+
+const bool
+CompiledWordlist::Open(
+    const std::filesystem::path Path
+)
+{
+    Close();
+
+    const int handle = open(Path.c_str(), O_RDONLY);
+    if (handle < 0)
+    {
+        std::cerr << "Error: unable to open " << Path << std::endl;
+        return false;
+    }
+
+    m_Size = std::filesystem::file_size(Path);
+    if (m_Size < sizeof(WordlistHeader))
+    {
+        std::cerr << "Error: " << Path << " is too small to be a compiled wordlist" << std::endl;
+        close(handle);
+        return false;
+    }
+
+    void* base = mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, handle, 0);
+    close(handle);
+    if (base == MAP_FAILED)
+    {
+        std::cerr << "Error: unable to map " << Path << std::endl;
+        return false;
+    }
+    m_Base = (const uint8_t*)base;
+
+    const WordlistHeader& header = GetHeader();
+    if (memcmp(header.Magic, WORDLIST_MAGIC, sizeof(header.Magic)) != 0 || header.Version != WORDLIST_VERSION)
+    {
+        std::cerr << "Error: " << Path << " is not a version " << WORDLIST_VERSION << " compiled wordlist" << std::endl;
+        Close();
+        return false;
+    }
+
+    if (header.BlockSize == 0 ||
+        header.DataOffset < sizeof(WordlistHeader) ||
+        header.IndexOffset % sizeof(uint64_t) != 0 ||
+        header.IndexOffset > m_Size ||
+        (m_Size - header.IndexOffset) / sizeof(uint64_t) < header.BlockCount + 1)
+    {
+        std::cerr << "Error: " << Path << " is truncated or corrupt" << std::endl;
+        Close();
+        return false;
+    }
+
+    m_Index = (const uint64_t*)&m_Base[header.IndexOffset];
+    m_DataEnd = m_Index[header.BlockCount];
+    if (m_Index[0] != header.DataOffset || m_DataEnd > header.IndexOffset ||
+        !std::is_sorted(m_Index, m_Index + header.BlockCount + 1))
+    {
+        std::cerr << "Error: " << Path << " has a corrupt block index" << std::endl;
+        Close();
+        return false;
+    }
+
+    // Candidates are read front to back
+    madvise(base, m_Size, MADV_SEQUENTIAL|MADV_WILLNEED);
+    return true;
+}
+
+void
+CompiledWordlist::Close(
+    void
+)
+{
+    if (m_Base != nullptr)
+    {
+        munmap((void*)m_Base, m_Size);
+    }
+    m_Base = nullptr;
+    m_Index = nullptr;
+    m_Size = 0;
+    m_DataEnd = 0;
+}
+
+const uint64_t
+CompiledWordlist::AlignToBlock(
+    const uint64_t Offset
+) const
+{
+    const uint64_t* end = m_Index + GetHeader().BlockCount + 1;
+    return *std::lower_bound(m_Index, end - 1, Offset);
+}
@@ -0,0 +1,98 @@
+//
+//  CompiledWordlist.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef CompiledWordlist_hpp
+#define CompiledWordlist_hpp
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+//
+// Layout of a compiled wordlist:
+//
+//   WordlistHeader
+//   Blocks of BlockSize candidates (the last may be short), each
+//   candidate a little endian uint16_t length followed by its bytes
+//   Padding to 8 bytes
+//   BlockCount + 1 uint64_t file offsets at IndexOffset, the start
+//   of every block followed by the end of the data
+//
+typedef struct __attribute__((packed)) _WordlistHeader
+{
+    char Magic[4];
+    uint32_t Version;
+    uint32_t Flags;
+    uint32_t BlockSize;
+    uint64_t WordCount;
+    uint64_t BlockCount;
+    uint64_t DataOffset;
+    uint64_t IndexOffset;
+    uint64_t SourceSize;
+} WordlistHeader;
+
+#define WORDLIST_MAGIC "CLWL"
+#define WORDLIST_VERSION (1)
+
+// $HEX[] candidates were decoded when compiling
+#define WORDLIST_FLAG_HEX (1 << 0)
+// Every duplicate was removed, not just adjacent ones
+#define WORDLIST_FLAG_DEDUP (1 << 1)
+
+// Candidates per block unless given, a power of two so it is a
+// multiple of the lanes of every SIMD width
+#define WORDLIST_BLOCK_SIZE (8192)
+
+// Longest candidate the length prefix can hold
+#define WORDLIST_MAX_WORD (UINT16_MAX)
+
+//
+// Read only view of a compiled wordlist. Candidates are stored
+// already parsed, so reading one is a length and a copy, and any
+// block can be found through the index without scanning.
+//
+class CompiledWordlist
+{
+public:
+    CompiledWordlist(void) = default;
+    ~CompiledWordlist(void) { Close(); }
+    static const bool IsCompiled(const std::filesystem::path Path);
+    const bool Open(const std::filesystem::path Path);
+    void Close(void);
+    const bool IsOpen(void) const { return m_Base != nullptr; }
+    const WordlistHeader& GetHeader(void) const { return *(const WordlistHeader*)m_Base; }
+    const uint64_t GetDataStart(void) const { return GetHeader().DataOffset; }
+    const uint64_t GetDataEnd(void) const { return m_DataEnd; }
+    const uint64_t GetBlockOffset(const size_t Block) const { return m_Index[Block]; }
+    // Offset of the first block starting at or after Offset
+    const uint64_t AlignToBlock(const uint64_t Offset) const;
+    // Reads the candidate at Offset and moves Offset past it, false
+    // if the data is truncated
+    const bool Read(uint64_t& Offset, std::string& Word) const
+    {
+        if (Offset + sizeof(uint16_t) > GetDataEnd())
+        {
+            return false;
+        }
+        const size_t length = m_Base[Offset] | (m_Base[Offset + 1] << 8);
+        if (Offset + sizeof(uint16_t) + length > GetDataEnd())
+        {
+            return false;
+        }
+        Word.assign((const char*)&m_Base[Offset + sizeof(uint16_t)], length);
+        Offset += sizeof(uint16_t) + length;
+        return true;
+    }
+private:
+    const uint8_t* m_Base = nullptr;
+    size_t m_Size = 0;
+    const uint64_t* m_Index = nullptr;
+    uint64_t m_DataEnd = 0;
+};
+
+#endif //CompiledWordlist_hpp
@@ -0,0 +1,151 @@
+//
+//  CpuFeatures.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <iostream>
+#include <stdlib.h>
+
+#include "CpuFeatures.hpp"
+
+typedef struct _SimdKernel
+{
+    IsaLevel Level;
+    size_t (*Lanes)(void);
+    void (*Hash)(const HashAlgorithm, const size_t*, const uint8_t**, uint8_t*);
+} SimdKernel;
+
+#ifdef CRACKLIST_SIMD_DISPATCH
+// Entry points of the SimdHash builds for each level, see
+// src/kernels/SimdKernel.cpp and cmake/PrefixSymbols.cmake
+#define DECLARE_KERNEL(Prefix) \
+    extern "C" size_t Prefix##_SimdKernelLanes(void); \
+    extern "C" void Prefix##_SimdKernelHash(const HashAlgorithm, const size_t*, const uint8_t**, uint8_t*);
+
+DECLARE_KERNEL(avx512)
+DECLARE_KERNEL(avx2)
+DECLARE_KERNEL(sse42)
+DECLARE_KERNEL(baseline)
+#endif
+
+// Widest first
+static const SimdKernel s_Kernels[] = {
+#ifdef CRACKLIST_SIMD_DISPATCH
+    {IsaLevelAVX512, avx512_SimdKernelLanes, avx512_SimdKernelHash},
+    {IsaLevelAVX2, avx2_SimdKernelLanes, avx2_SimdKernelHash},
+    {IsaLevelSSE42, sse42_SimdKernelLanes, sse42_SimdKernelHash},
+    {IsaLevelBaseline, baseline_SimdKernelLanes, baseline_SimdKernelHash},
+#else
+    // Only the SimdHash library as built, at whatever width
+    // it was compiled for
+    {
+        IsaLevelBaseline,
+        []{ return (size_t)SimdLanes(); },
+        [](const HashAlgorithm Algorithm, const size_t* Lengths, const uint8_t** Buffers, uint8_t* Digests) {
+            SimdHash(Algorithm, Lengths, Buffers, Digests);
+        }
+    },
+#endif
+};
+
+namespace CpuFeatures
+{
+
+static const SimdKernel&
+Kernel(
+    void
+)
+{
+    static const SimdKernel& kernel = []() -> const SimdKernel& {
+        const IsaLevel level = Detect();
+        for (const SimdKernel& candidate : s_Kernels)
+        {
+            if (candidate.Level <= level && candidate.Lanes() <= CPU_MAX_LANES)
+            {
+                return candidate;
+            }
+        }
+        // Lane buffers are sized for CPU_MAX_LANES, so a wider build
+        // cannot be used at all
+        std::cerr << "Error: no SimdHash kernel with at most " << CPU_MAX_LANES << " lanes" << std::endl;
+        abort();
+    }();
+    return kernel;
+}
+
+const IsaLevel
+Detect(
+    void
+)
+{
+#if defined(__x86_64__)
+    // The kernels are built with -march=x86-64-v4/v3/v2, which allow
+    // every instruction of the level (AVX512BW/VL, BMI2, FMA, MOVBE
+    // and so on), so the whole level has to be supported
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("x86-64-v4"))
+    {
+        return IsaLevelAVX512;
+    }
+    if (__builtin_cpu_supports("x86-64-v3"))
+    {
+        return IsaLevelAVX2;
+    }
+    if (__builtin_cpu_supports("x86-64-v2"))
+    {
+        return IsaLevelSSE42;
+    }
+#endif
+    return IsaLevelBaseline;
+}
+
+const char*
+IsaLevelToString(
+    const IsaLevel Level
+)
+{
+    switch (Level)
+    {
+        case IsaLevelAVX512:
+            return "AVX-512";
+        case IsaLevelAVX2:
+            return "AVX2";
+        case IsaLevelSSE42:
+            return "SSE4.2";
+        default:
+            return "baseline";
+    }
+}
+
+const IsaLevel
+KernelLevel(
+    void
+)
+{
+    return Kernel().Level;
+}
+
+const size_t
+Lanes(
+    void
+)
+{
+    static const size_t lanes = Kernel().Lanes();
+    return lanes;
+}
+
+void
+Hash(
+    const HashAlgorithm Algorithm,
+    const size_t* Lengths,
+    const uint8_t** Buffers,
+    uint8_t* Digests
+)
+{
+    Kernel().Hash(Algorithm, Lengths, Buffers, Digests);
+}
+
+}
@@ -0,0 +1,115 @@
+//
+//  CpuFeatures.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef CpuFeatures_hpp
+#define CpuFeatures_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string.h>
+#include <string>
+
+#include "simdhash.h"
+
+// The x86-64 microarchitecture levels: baseline, v2, v3 and v4
+typedef enum
+{
+    IsaLevelBaseline,
+    IsaLevelSSE42,
+    IsaLevelAVX2,
+    IsaLevelAVX512
+} IsaLevel;
+
+// Compiles a kernel once per ISA level. The loader picks the widest
+// version the CPU supports, so one binary runs across the fleet
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define MULTIVERSION __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#endif
+#endif
+
+#ifndef MULTIVERSION
+#define MULTIVERSION
+#endif
+
+// For declarations in headers. Clang wants the attribute on every
+// declaration, GCC emits a resolver in each unit that sees one so
+// there it only goes on the definition
+#if defined(__clang__)
+#define MULTIVERSION_DECL MULTIVERSION
+#else
+#define MULTIVERSION_DECL
+#endif
+
+// Lanes of the widest hash kernel, 32 bit words in 512 bit registers
+#define CPU_MAX_LANES (16)
+
+//
+// Fixed input buffers for CPU_MAX_LANES strings of up to N bytes, so
+// callers do not depend on the width the kernels were built for
+//
+template<size_t N>
+class SimdLaneBuffer
+{
+public:
+    SimdLaneBuffer(void)
+    {
+        for (size_t i = 0; i < CPU_MAX_LANES; i++)
+        {
+            m_Buffers[i] = m_Data[i];
+        }
+    }
+    void Set(const size_t Lane, const std::string& Value) { memcpy(m_Data[Lane], Value.data(), Value.size()); m_Lengths[Lane] = Value.size(); }
+    const size_t* GetLengths(void) const { return m_Lengths; }
+    const uint8_t** ConstBuffers(void) { return m_Buffers; }
+private:
+    alignas(64) uint8_t m_Data[CPU_MAX_LANES][N];
+    size_t m_Lengths[CPU_MAX_LANES] = {0};
+    const uint8_t* m_Buffers[CPU_MAX_LANES];
+};
+
+namespace CpuFeatures
+{
+
+// The widest ISA level this CPU supports every feature of
+const IsaLevel
+Detect(
+    void
+);
+
+const char*
+IsaLevelToString(
+    const IsaLevel Level
+);
+
+// ISA level of the SIMD hash kernels in use, the widest built that
+// the CPU supports, chosen on first use. Always baseline unless built
+// with CRACKLIST_SIMD_DISPATCH
+const IsaLevel
+KernelLevel(
+    void
+);
+
+// Lanes hashed by each call to Hash
+const size_t
+Lanes(
+    void
+);
+
+// Hashes Lanes() buffers with the selected kernel
+void
+Hash(
+    const HashAlgorithm Algorithm,
+    const size_t* Lengths,
+    const uint8_t** Buffers,
+    uint8_t* Digests
+);
+
+}
+
+#endif /* CpuFeatures_hpp */
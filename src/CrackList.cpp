@@ -9,60 +9,135 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <fcntl.h>
+#include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <linux/perf_event.h>
+#include <numeric>
+#include <random>
+#include <poll.h>
+#include <signal.h>
+#include <sstream>
 #include <string>
 #include <string.h>
 #include <sys/mman.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <thread>
 #include <tuple>
 #include <vector>
 
 #include "simdhash.h"
-#include "SimdHashBuffer.hpp"
 
+#include "AtomicBitmap.hpp"
 #include "Common.hpp"
+#include "CpuFeatures.hpp"
 #include "CrackList.hpp"
 #include "HashList.hpp"
+#include "Trace.hpp"
 #include "Util.hpp"
 
 #define MAX_STRING_LENGTH 128
-
-const bool
-CrackList::CrackLinear(
-    void
+// The most compression blocks a word that fits in a lane can need
+#define MAX_LANE_BLOCKS ((MAX_STRING_LENGTH * 2 + 8) / 64 + 1)
+// The number of target digests read per sequential
+// read while merge joining against the hash file
+#define MERGE_READ_COUNT (1024 * 1024)
+// Minimum time between status line updates
+#define STATUS_INTERVAL_MS (250)
+// Generated candidates and targets for --benchmark, one in
+// BENCHMARK_HIT_RATE candidates is in the target list
+#define BENCHMARK_CANDIDATES (1 << 20)
+#define BENCHMARK_TARGETS (1 << 20)
+#define BENCHMARK_HIT_RATE (1024)
+// How long each benchmark configuration runs for
+#define BENCHMARK_RUN_MS (1000)
+// The hash file is checked for appended targets at least this
+// often, inotify wakes the watcher sooner on Linux
+#define WATCH_POLL_MS (1000)
+
+// Set by SIGINT/SIGTERM while checkpointing
+static std::atomic<bool> s_Interrupted = false;
+
+static void
+Interrupt(
+    int Signal
 )
 {
-    std::ostream& output = m_OutputFileStream.is_open() ? m_OutputFileStream : std::cout;
-    std::string last_cracked;
-
-    std::cerr << "Performing linear crack" << std::endl;
-
-    auto start = std::chrono::system_clock::now();
+    s_Interrupted = true;
+    // A second signal terminates immediately
+    signal(Signal, SIG_DFL);
+}
 
-    const size_t lanes = SimdLanes();
+void
+CrackList::HashBlock(
+    const std::string* Words,
+    const size_t Count,
+    uint8_t* Digests,
+    const uint8_t* Skip,
+    ThreadMetrics* Metrics
+) const
+{
+    const size_t lanes = CpuFeatures::Lanes();
     const size_t hashWidth = GetHashWidth(m_Algorithm);
-    SimdHashBufferFixed<MAX_STRING_LENGTH> words;
-    std::array<uint8_t, MAX_HASH_SIZE * MAX_LANES> hashes;
+    SimdLaneBuffer<MAX_STRING_LENGTH> words;
+    std::array<uint8_t, MAX_HASH_SIZE * CPU_MAX_LANES> hashes;
 
-    while (!m_Exhausted)
+    // Bin the words by compression block count so that every lane of
+    // a SIMD call does the same amount of work. Words too long for a
+    // lane are hashed one at a time instead
+    std::array<std::vector<uint32_t>, MAX_LANE_BLOCKS + 1> bins;
     {
-        auto block = ReadBlock();
+        StageTimer timer(Metrics, StagePack);
+        TRACE_SPAN("pack");
+        for (size_t i = 0; i < Count; i++)
+        {
+            if (Skip != nullptr && Skip[i])
+            {
+                continue;
+            }
+            const size_t length = Words[i].size();
+            const size_t bin = length > MAX_STRING_LENGTH ? 0 : CompressionBlocks(m_Algorithm, length);
+            bins[bin].push_back(i);
+        }
+    }
 
-        // Can be empty if the input is blocksize aligned
-        if (block.empty())
+    StageTimer timer(Metrics, StageHash);
+    TRACE_SPAN("hash");
+
+    for (const uint32_t index : bins[0])
+    {
+        uint8_t* const hash = &hashes[0];
+        DoHash(m_Algorithm, (const uint8_t*)Words[index].data(), Words[index].size(), hash);
+        // In linkedin mode we need to mask
+        // the high order bytes
+        if (m_LinkedIn)
         {
-            continue;
+            *(uint16_t*)hash = 0;
+            hash[2] &= 0x0f;
         }
+        memcpy(Digests + index * m_DigestLength, hash, m_DigestLength);
+    }
 
-        for (size_t i = 0; i < block.size(); i+=lanes)
+    for (size_t bin = 1; bin < bins.size(); bin++)
+    {
+        const std::vector<uint32_t>& indices = bins[bin];
+        for (size_t i = 0; i < indices.size(); i+=lanes)
         {
-            const size_t remaining = std::min(lanes, block.size() - i);
+            const size_t remaining = std::min(lanes, indices.size() - i);
             for (size_t h = 0; h < remaining; h++)
             {
-                words.Set(h, block[i + h]);
+                words.Set(h, Words[indices[i + h]]);
+            }
+            // Keep stale lanes from a longer bin out of the call
+            for (size_t h = remaining; h < lanes; h++)
+            {
+                words.Set(h, Words[indices[i]]);
             }
 
-            SimdHash(
+            CpuFeatures::Hash(
                 m_Algorithm,
                 words.GetLengths(),
                 words.ConstBuffers(),
@@ -72,523 +147,1628 @@ CrackList::CrackLinear(
             for (size_t h = 0; h < remaining; h++)
             {
                 uint8_t* const hash = &hashes[h * hashWidth];
-                // In linkedin mode we need to mask
-                // the high order bytes
                 if (m_LinkedIn)
                 {
                     *(uint16_t*)hash = 0;
                     hash[2] &= 0x0f;
                 }
-                if (m_HashList.Lookup(hash))
-                {
-                    auto hex = Util::ToHex(hash, m_DigestLength);
-                    hex = Util::ToLower(hex);
-                    m_Cracked++;
-                    output << hex << m_Separator << Util::Hexlify(words.GetString(h)) << std::endl;
-                    last_cracked = block[h];
-                }
+                memcpy(Digests + indices[i + h] * m_DigestLength, hash, m_DigestLength);
             }
         }
-
-        m_BlocksProcessed++;
-
-        auto end = std::chrono::system_clock::now();
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-        ThreadPulse(0, elapsed_ms.count(), last_cracked, block.back());
-        start = std::chrono::system_clock::now();
-
-        if (m_Cracked == m_Count)
-        {
-            break;
-        }
     }
-    return true;
 }
 
 void
-CrackList::OutputResultsInternal(
-    std::vector<std::tuple<std::vector<uint8_t>,std::string,std::string>>& Results
+CrackList::CrackBlock(
+    const std::vector<std::string>& Block,
+    std::vector<CrackResult>& Results,
+    const bool Unique
 )
 {
-    std::ostream& output = m_OutputFileStream.is_open() ? m_OutputFileStream : std::cout;
-
-    for (auto& [h,x,v] : Results)
-    {
-        m_Cracked++;
-        output << x << m_Separator << v << std::endl;
-        m_LastCracked = v;
-    }
-
-    // Check if we have found all the tarets
-    if (m_Cracked == m_Count)
-    {
-        m_Finished = true;
-    }
+    CrackBlock(m_HashList, Block, Results, Unique);
 }
 
 void
-CrackList::OutputResults(
-    void
+CrackList::CrackBlock(
+    HashList& List,
+    const std::vector<std::string>& Block,
+    std::vector<CrackResult>& Results,
+    const bool Unique,
+    ThreadMetrics* Metrics
 )
 {
-    // Take a copy of the results
-    std::vector<std::tuple<std::vector<uint8_t>,std::string,std::string>> copy;
+    std::vector<uint8_t> digests(Block.size() * m_DigestLength);
+    std::vector<uint8_t> skip;
+
+    // Repeats can only crack what their first occurrence already has
+    if (m_Seen && Unique)
     {
-        std::lock_guard<std::mutex> lock(m_ResultsMutex);
-        copy = std::move(m_Results);
+        size_t duplicates = 0;
+        skip.resize(Block.size());
+        for (size_t i = 0; i < Block.size(); i++)
+        {
+            if (!m_Seen->Insert(Block[i]))
+            {
+                skip[i] = 1;
+                duplicates++;
+            }
+        }
+        m_DedupChecked += Block.size();
+        m_DedupSkipped += duplicates;
     }
 
-    OutputResultsInternal(copy);
-}
-
-void
-CrackList::ThreadPulse(
-    const size_t ThreadId,
-    const uint64_t BlockTime,
-    const std::string LastCracked,
-    const std::string LastTry
-)
-{
-    m_LastBlockMs[ThreadId] = BlockTime;
+    HashBlock(&Block[0], Block.size(), &digests[0], skip.empty() ? nullptr : &skip[0], Metrics);
 
-    if (!LastCracked.empty())
+    StageTimer timer(Metrics, StageLookup);
+    TRACE_SPAN("lookup");
+    const size_t hits = Results.size();
+    // Targets appended since loading, taken once for the block
+    auto delta = m_Delta ? m_Delta->Acquire() : nullptr;
+    for (size_t i = 0; i < Block.size(); i++)
     {
-        m_LastCracked = LastCracked;
-    }
+        if (!skip.empty() && skip[i])
+        {
+            continue;
+        }
 
-    std::string printable_cracked = Util::Hexlify(m_LastCracked);
-    std::transform(printable_cracked.begin(), printable_cracked.end(), printable_cracked.begin(),
-        [](unsigned char c){ return c > ' ' && c < '~' ? c : ' ' ; });
+        const uint8_t* const hash = &digests[i * m_DigestLength];
+        const size_t index = List.Lookup(hash);
+        if (index != HASH_NOT_FOUND)
+        {
+            // Only the first thread to crack a target reports it
+            if (Unique && !List.MarkCracked(index))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            const size_t slot = delta && delta->Count ? m_Delta->Lookup(*delta, hash) : HASH_NOT_FOUND;
+            if (slot == HASH_NOT_FOUND || (Unique && !m_Delta->MarkCracked(slot)))
+            {
+                continue;
+            }
+        }
 
-    std::string printable_last = Util::Hexlify(LastTry);
-    std::transform(printable_last.begin(), printable_last.end(), printable_last.begin(),
-        [](unsigned char c){ return c > ' ' && c < '~' ? c : ' ' ; });
+        auto hex = Util::ToHex(hash, m_DigestLength);
+        Results.push_back({std::vector<uint8_t>(hash, hash + m_DigestLength), hex, Util::Hexlify(Block[i]), index});
+    }
 
-    // Output the status if we are not printing to stdout
-    if (!m_OutFile.string().empty())
+    if (Metrics != nullptr)
     {
-        uint64_t averageMs = 0;
-        for (auto const& [thread, val] : m_LastBlockMs)
-        {
-            averageMs += val;
-        }
-        // The average time a thread takes to do one block in ms
-        averageMs /= m_Threads;
-
-        // The number of hashes per second
-        std::string hps_ch;
-        double hashesPerSec = (double)(m_BlockSize * 1000 * m_Threads) / averageMs;
-        hashesPerSec = Util::NumFactor(hashesPerSec, hps_ch);
-        // double hashesPerSec = (double)(m_BlockSize * 1000) / BlockTime;
-
-        const size_t hashcount = m_HashList.GetCount();
-        double percent = ((double)m_Cracked / hashcount) * 100.f;
-
-        char statusbuf[m_TerminalWidth];
-        statusbuf[sizeof(statusbuf) - 1] = '\0';
-        fprintf(stderr, "%s", "\r");
-        fflush(stderr);
-        memset(statusbuf, ' ', m_TerminalWidth - 1);
-        size_t wordsProcessed = m_WordsProcessed;
-        int count = snprintf(
-            statusbuf, m_TerminalWidth,
-            "H/s:%.1lf%s C:%zu/%zu (%.1lf%%) T:%zu C:\"%s\" L:\"%s\"",
-                hashesPerSec,
-                hps_ch.c_str(),
-                m_Cracked,
-                hashcount,
-                percent,
-                wordsProcessed,
-                printable_cracked.c_str(),
-                printable_last.c_str()
-        );
-        if (count < m_TerminalWidth - 1)
-        {
-            statusbuf[count] = ' ';
-        }
-        fprintf(stderr, "%s", statusbuf);
+        Metrics->Add(Metrics->Candidates, Block.size());
+        Metrics->Add(Metrics->Blocks, 1);
+        Metrics->Add(Metrics->Hits, Results.size() - hits);
     }
 }
 
-void
-CrackList::WorkerFinished(
+const bool
+CrackList::CrackMerge(
     void
 )
 {
-    if (--m_ActiveWorkers == 0)
+    std::ostream& output = m_OutputFileStream.is_open() ? m_OutputFileStream : std::cout;
+
+    FILE* targets = fopen(m_HashFile.c_str(), "rb");
+    if (targets == nullptr)
     {
-        // Stop the pool
-        m_DispatchPool->Stop();
-        m_DispatchPool->Wait();
-        // Stop the current main thread
-        dispatch::CurrentDispatcher()->Stop();
+        std::cerr << "Error: unable to open binary hash file" << std::endl;
+        return false;
     }
-}
+    posix_fadvise(fileno(targets), 0, 0, POSIX_FADV_SEQUENTIAL);
 
-void
-CrackList::CrackWorker(
-    const size_t Id
-)
-{
-    std::vector<std::string> block;
-    std::string last_cracked;
+    std::cerr << "Performing sort-merge crack" << std::endl;
+
+    const size_t threads = m_Threads == 0 ? std::thread::hardware_concurrency() : m_Threads;
+    const size_t lanes = CpuFeatures::Lanes();
 
-    srand(Id);
+    std::vector<std::string> batch;
+    std::vector<uint8_t> digests;
+    std::vector<uint32_t> order;
+    std::vector<uint8_t> chunk(MERGE_READ_COUNT * m_DigestLength);
+    std::vector<uint8_t> previous(m_DigestLength);
+    size_t batchNumber = 0;
+    AtomicBitmap cracked(m_Count);
+    bool uniqueCounted = false;
+    size_t unique = 0;
 
-    // Check if all input is done
+    while (!m_Exhausted && m_Cracked < m_Count)
     {
-        std::lock_guard<std::mutex> lock(m_InputMutex);
-        if (m_Finished && m_InputCache.empty())
+        batch.clear();
+        while (!m_Exhausted && batch.size() < m_MergeBatchSize)
         {
-            // Track the completion of this worker
-            dispatch::PostTaskToDispatcher(
-                "main",
-                std::bind(
-                    &CrackList::WorkerFinished,
-                    this
-                )
-            );
-            // Terminate our current queue
-            dispatch::CurrentQueue()->Stop();
-            return;
+            auto block = ReadBlock();
+            batch.insert(batch.end(), std::make_move_iterator(block.begin()), std::make_move_iterator(block.end()));
         }
 
-        if (!m_InputCache.empty())
+        if (batch.empty())
         {
-            block = std::move(m_InputCache.front());
-            m_InputCache.pop();
+            continue;
         }
-    }
-
-    // We need to wait for more input
-    if (block.empty())
-    {
-        usleep(rand() % 100);
-        dispatch::PostTaskFast(
-            dispatch::bind(
-                &CrackList::CrackWorker,
-                this,
-                Id
-            )
-        );
-        return;
-    }
 
-    std::vector<std::tuple<std::vector<uint8_t>,std::string,std::string>> cracked;
-
-    auto start = std::chrono::system_clock::now();
-
-    const size_t lanes = SimdLanes();
-    const size_t hashWidth = GetHashWidth(m_Algorithm);
-    SimdHashBufferFixed<MAX_STRING_LENGTH> words;
-    std::array<uint8_t, MAX_HASH_SIZE * MAX_LANES> hashes;
+        auto start = std::chrono::system_clock::now();
 
-    for (size_t i = 0; i < block.size(); i+=lanes)
-    {
-        const size_t remaining = std::min(lanes, block.size() - i);
-        for (size_t h = 0; h < remaining; h++)
+        // Hash the whole batch, splitting it into lane aligned slices
+        digests.resize(batch.size() * m_DigestLength);
+        const size_t slice = ((batch.size() / threads) / lanes + 1) * lanes;
+        std::vector<std::thread> hashers;
+        for (size_t first = 0; first < batch.size(); first += slice)
         {
-            words.Set(h, block[i + h]);
+            hashers.emplace_back(
+                &CrackList::HashBlock,
+                this,
+                &batch[first],
+                std::min(slice, batch.size() - first),
+                &digests[first * m_DigestLength],
+                nullptr,
+                nullptr
+            );
+        }
+        for (auto& hasher : hashers)
+        {
+            hasher.join();
         }
 
-        SimdHash(
-            m_Algorithm,
-            words.GetLengths(),
-            words.ConstBuffers(),
-            &hashes[0]
-        );
-
-        for (size_t h = 0; h < remaining; h++)
+        // Sort the candidates by digest
+        order.resize(batch.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+            [&](const uint32_t a, const uint32_t b) {
+                return memcmp(&digests[a * m_DigestLength], &digests[b * m_DigestLength], m_DigestLength) < 0;
+            });
+
+        // Stream the sorted target list and merge join against it. We
+        // can stop reading as soon as every candidate has been passed,
+        // except on the first pass where we also count unique targets
+        size_t hits = 0;
+        size_t next = 0;
+        size_t position = 0;
+        rewind(targets);
+        while (next < order.size() || !uniqueCounted)
         {
-            uint8_t* const hash = &hashes[h * hashWidth];
-            // In linkedin mode we need to mask
-            // the high order bytes
-            if (m_LinkedIn)
+            const size_t read = fread(&chunk[0], m_DigestLength, MERGE_READ_COUNT, targets);
+            if (read == 0)
+            {
+                break;
+            }
+
+            if (!uniqueCounted)
             {
-                *(uint16_t*)hash = 0;
-                hash[2] &= 0x0f;
+                unique += HashList::CountUnique(&chunk[0], read, m_DigestLength, position == 0 ? nullptr : &previous[0]);
+                memcpy(&previous[0], &chunk[(read - 1) * m_DigestLength], m_DigestLength);
             }
-            if (m_HashList.Lookup(hash))
+
+            const uint8_t* target = &chunk[0];
+            const uint8_t* const end = target + read * m_DigestLength;
+            while (next < order.size() && target < end)
             {
-                auto hex = Util::ToHex(hash, m_DigestLength);
-                hex = Util::ToLower(hex);
-                cracked.push_back({std::vector<uint8_t>(hash, hash + m_DigestLength), hex, Util::Hexlify(words.GetString(h))});
+                const uint8_t* const candidate = &digests[order[next] * m_DigestLength];
+                const int cmp = memcmp(candidate, target, m_DigestLength);
+                if (cmp < 0)
+                {
+                    next++;
+                }
+                else if (cmp > 0)
+                {
+                    target += m_DigestLength;
+                }
+                else
+                {
+                    // The first entry of a run of duplicate targets
+                    // is always the one that we match against
+                    const size_t index = position + (target - &chunk[0]) / m_DigestLength;
+                    if (cracked.Set(index))
+                    {
+                        auto hex = Util::ToHex(candidate, m_DigestLength);
+                        m_Cracked++;
+                        hits++;
+                        output << hex << m_Separator << Util::Hexlify(batch[order[next]]) << std::endl;
+                        m_LastCracked = batch[order[next]];
+                    }
+                    // Skip any other candidates with the same digest
+                    while (next < order.size() &&
+                        memcmp(&digests[order[next] * m_DigestLength], target, m_DigestLength) == 0)
+                    {
+                        next++;
+                    }
+                }
             }
+
+            position += read;
         }
-    }
 
-    auto end = std::chrono::system_clock::now();
-    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        if (!uniqueCounted && position == m_Count)
+        {
+            uniqueCounted = true;
+            m_Count = unique;
+        }
 
-    if (cracked.size() > 0)
-    {
-        std::lock_guard<std::mutex> lock(m_ResultsMutex);
-        last_cracked = std::get<2>(cracked.back());
-        OutputResultsInternal(cracked);
-        // bool willupdate = m_Results.size() < 8192;
-        // m_Results.insert(m_Results.end(), cracked.begin(), cracked.end());
-        // if (m_Results.size() > 8192 && willupdate)
-        // {
-        //     dispatch::PostTaskToDispatcher(
-        //         "io",
-        //         std::bind(
-        //             &CrackList::OutputResults,
-        //             this
-        //         )
-        //     );
-        // }
+        m_BlocksProcessed++;
+
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+        std::cerr << "Batch " << batchNumber++ << ": " << batch.size() << " candidates, " << hits << " cracked, ";
+        std::cerr << m_Cracked << "/" << m_Count << " total in " << elapsed_ms.count() << "ms" << std::endl;
     }
 
-    m_BlocksProcessed++;
+    if (!m_LeftFile.empty())
+    {
+        FILE* left = fopen(m_LeftFile.c_str(), "wb");
+        if (left == nullptr)
+        {
+            std::cerr << "Error: unable to open " << m_LeftFile << " for writing" << std::endl;
+            fclose(targets);
+            return false;
+        }
 
-    dispatch::PostTaskToDispatcher(
-        "main",
-        std::bind(
-            &CrackList::ThreadPulse,
-            this,
-            Id,
-            elapsed_ms.count(),
-            last_cracked,
-            block.back()
-        )
-    );
+        // Stream the target list once more skipping the cracked entries
+        size_t read;
+        size_t position = 0;
+        size_t written = 0;
+        const bool binary = HashList::IsBinaryPath(m_LeftFile);
+        rewind(targets);
+        while ((read = fread(&chunk[0], m_DigestLength, MERGE_READ_COUNT, targets)) > 0)
+        {
+            written += HashList::WriteUncracked(&chunk[0], read, m_DigestLength, cracked, position, binary, left, position == 0 ? nullptr : &previous[0]);
+            memcpy(&previous[0], &chunk[(read - 1) * m_DigestLength], m_DigestLength);
+            position += read;
+        }
+        fclose(left);
+        std::cerr << "Wrote " << written << " uncracked hashes to " << m_LeftFile << std::endl;
+    }
 
-    dispatch::PostTaskFast(
-        std::bind(
-            &CrackList::CrackWorker,
-            this,
-            Id
-        )
-    );
+    fclose(targets);
+    return true;
 }
 
-std::vector<std::string>
-CrackList::ReadBlock(
+const bool
+CrackList::CrackLinear(
     void
 )
 {
-    std::istream& input = m_WordlistFileStream.is_open() ? m_WordlistFileStream : std::cin;
-    std::vector<std::string> block;
-    std::string line;
+    std::cerr << "Performing linear crack" << std::endl;
 
-    block.reserve(m_BlockSize);
+    m_Metrics.Reset(1);
+    ThreadMetrics* const metrics = m_Metrics.GetWorker(0);
+    StartStatus();
+    TRACE_THREAD("worker", 0);
 
-    // Loop until the block is full or the input is exhausted
-    while(block.size() < m_BlockSize)
+    while (!m_Exhausted && !m_Complete && !s_Interrupted)
     {
-        if (input.eof())
+        std::vector<std::string> block;
         {
-            m_Exhausted = true;
-            break;
+            StageTimer timer(m_Metrics.GetReader(), StageRead);
+            TRACE_SPAN("read");
+            block = ReadBlock();
         }
 
-        std::getline(input, line);
-
-        // Strip carriage return if present at the end
-        if (!line.empty() && line.back() == '\r')
+        // Can be empty if the input is blocksize aligned
+        if (block.empty())
         {
-            line.pop_back();
+            continue;
         }
 
-        if (line.empty() || line == m_LastLine)
+        std::vector<CrackResult> cracked;
+        CrackBlock(m_HashList, block, cracked, true, metrics);
+
+        if (!cracked.empty())
         {
-            continue;
+            StageTimer timer(metrics, StageOutput);
+            TRACE_SPAN("output");
+            std::lock_guard<std::mutex> lock(m_ResultsMutex);
+            OutputResultsInternal(cracked);
         }
 
-        // Handle parsing "$HEX[]" input.
-        if (m_ParseHexInput && line.starts_with("$HEX[") && line.back() == ']')
+        m_BlocksProcessed++;
+        m_Checkpoint.Complete(m_NextSequence++, m_ReadOffset, block.size());
+
+        if (m_Complete)
         {
-            auto bytes = Util::ParseHex(line.substr(5, line.size() - 6));
-            line = std::string(bytes.begin(), bytes.end());
+            break;
         }
-
-        m_LastLine = line;
-        block.push_back(std::move(line));
-        m_WordsProcessed++;
     }
 
-    return block;
+    StopStatus();
+    return true;
 }
 
 void
-CrackList::ReadInput(
-    void
+CrackList::OutputResultsInternal(
+    std::vector<CrackResult>& Results
 )
 {
-    // Terminate our current queue
-    if (m_Exhausted)
-    {
-        // Signal to stop reading input
-        m_Finished = true;
-        // Kill the IO thread
-        dispatch::CurrentQueue()->Stop();
-        return;
-    }
-
-    bool cache_full = false;
+    std::ostream& output = m_OutputFileStream.is_open() ? m_OutputFileStream : std::cout;
 
-    while(!m_Exhausted && !cache_full)
+    for (auto& [h,x,v,index] : Results)
     {
-        auto block = ReadBlock();
-
-        if (!block.empty())
+        // Appended targets are not part of the checkpoint
+        if (m_Reported && index != HASH_NOT_FOUND)
         {
-            std::lock_guard<std::mutex> lock(m_InputMutex);
-
-            m_InputCache.push(
-                std::move(block)
-            );
-            
-            if (m_InputCache.size() >= m_CacheSizeBlocks)
-            {
-                cache_full = true;
-            }
+            m_Reported->Set(index);
         }
+        m_Cracked++;
+        output << x << m_Separator << v << std::endl;
+        m_LastCracked = v;
+    }
+
+    // Check if we have found all the tarets
+    if (m_Cracked == m_Count)
+    {
+        m_Complete = true;
     }
+}
 
-    if (cache_full)
+void
+CrackList::OutputResults(
+    void
+)
+{
+    // Take a copy of the results
+    std::vector<CrackResult> copy;
     {
-        usleep(20);
+        std::lock_guard<std::mutex> lock(m_ResultsMutex);
+        copy = std::move(m_Results);
     }
 
-    // Post the next task
-    dispatch::PostTaskFast(
-        dispatch::bind(
-            &CrackList::ReadInput,
-            this
-        )
-    );
+    OutputResultsInternal(copy);
 }
 
-const bool
-CrackList::Crack(
+void
+CrackList::StartStatus(
     void
 )
 {
-    bool result = false;
+    m_StatusStop = false;
+    m_StatusThread = std::thread(&CrackList::StatusWorker, this);
+}
 
-    // Check parameters
-    if (m_HashFile == "")
+void
+CrackList::StopStatus(
+    void
+)
+{
     {
-        std::cerr << "Error: no hash file specified" << m_HashFile << std::endl;
-        return false;
+        std::lock_guard<std::mutex> lock(m_StatusMutex);
+        m_StatusStop = true;
     }
+    m_StatusWake.notify_all();
+    m_StatusThread.join();
+}
 
-    if (m_BlockSize % SimdLanes() != 0)
-    {
-        std::cerr << "Error: Block Size must be a multiple of Simd Lanes (" << SimdLanes() << ")" << std::endl;
-        return false;
-    }
+void
+CrackList::StatusWorker(
+    void
+)
+{
+    TRACE_THREAD("status", 0);
+    auto lastTick = std::chrono::steady_clock::now();
+    auto lastJson = lastTick;
+    uint64_t lastCandidates = 0;
+    bool stopping = false;
 
-    // Open the input file
-    if (m_Wordlist != "-" && m_Wordlist != "")
+    while (!stopping)
     {
-        if (!std::filesystem::exists(m_Wordlist))
         {
-            std::cerr << "Error: Wordlist file does not exist" << std::endl;
-            return false;
+            std::unique_lock<std::mutex> lock(m_StatusMutex);
+            stopping = m_StatusWake.wait_for(lock, std::chrono::milliseconds(STATUS_INTERVAL_MS), [this]{ return m_StatusStop; });
         }
-        m_WordlistFileStream.open(m_Wordlist, std::ios::in);
-    }
 
-    if (m_OutFile != "")
-    {
-        m_OutputFileStream.open(m_OutFile, std::ios::out | std::ios::app);
-    }
+        // Throughput over the last tick, from what the workers
+        // have finished rather than from per block timings
+        const auto now = std::chrono::steady_clock::now();
+        const uint64_t candidates = m_Metrics.GetCandidates();
+        const uint64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - lastTick).count();
+        const double hashesPerSec = elapsedUs ? (double)(candidates - lastCandidates) * 1000000 / elapsedUs : 0;
+        lastTick = now;
+        lastCandidates = candidates;
 
-    // Detect the input type
-    if (m_HashType == InputTypeUnknown)
-    {
-        if (m_HashFile.ends_with(".txt") || m_HashFile.ends_with(".lst"))
-        {
-            m_HashType = InputTypeText;
-        }
-        else if (m_HashFile.ends_with(".bin") || m_HashFile.ends_with(".dat"))
+        m_Metrics.SetQueueDepth(m_Pool ? m_Pool->GetQueued() : 0);
+
+        if (m_Checkpoint.Due())
         {
-            m_HashType = InputTypeBinary;
+            TRACE_SPAN("checkpoint");
+            SaveCheckpoint();
         }
-        else if (Util::IsHex(m_HashFile))
+
+        if (!stopping)
         {
-            m_HashType = InputTypeSingle;
+            PrintStatus(hashesPerSec);
         }
-        else
+
+        // The final write reports the whole run
+        if (!m_StatusJson.empty() && (stopping || now - lastJson >= std::chrono::seconds(m_StatusInterval)))
         {
-            std::cerr << "Error: Unable to determine input hash file type" << std::endl;
-            return false;
+            const uint64_t elapsedMs = m_Metrics.GetElapsedMs();
+            WriteStatusJson(stopping ? (elapsedMs ? (double)candidates * 1000 / elapsedMs : 0) : hashesPerSec);
+            lastJson = now;
+        }
+    }
+}
+
+void
+CrackList::PrintStatus(
+    const double HashesPerSec
+)
+{
+    // Output the status if we are not printing to stdout
+    if (m_OutFile.string().empty())
+    {
+        return;
+    }
+
+    std::string lastCracked;
+    size_t cracked;
+    {
+        std::lock_guard<std::mutex> lock(m_ResultsMutex);
+        lastCracked = m_LastCracked;
+        cracked = m_Cracked;
+    }
+
+    std::string lastTry;
+    {
+        std::lock_guard<std::mutex> lock(m_StatusMutex);
+        lastTry = m_LastTry;
+    }
+
+    std::string printable_cracked = Util::Hexlify(lastCracked);
+    std::transform(printable_cracked.begin(), printable_cracked.end(), printable_cracked.begin(),
+        [](unsigned char c){ return c > ' ' && c < '~' ? c : ' ' ; });
+
+    std::string printable_last = Util::Hexlify(lastTry);
+    std::transform(printable_last.begin(), printable_last.end(), printable_last.begin(),
+        [](unsigned char c){ return c > ' ' && c < '~' ? c : ' ' ; });
+
+    // The number of hashes per second
+    std::string hps_ch;
+    const double hashesPerSec = Util::NumFactor(HashesPerSec, hps_ch);
+
+    const size_t hashcount = m_Count;
+    double percent = ((double)cracked / hashcount) * 100.f;
+
+    char statusbuf[m_TerminalWidth];
+    statusbuf[sizeof(statusbuf) - 1] = '\0';
+    fprintf(stderr, "%s", "\r");
+    fflush(stderr);
+    memset(statusbuf, ' ', m_TerminalWidth - 1);
+    size_t wordsProcessed = m_WordsProcessed;
+    int count = snprintf(
+        statusbuf, m_TerminalWidth,
+        "H/s:%.1lf%s C:%zu/%zu (%.1lf%%) T:%zu Q:%zu C:\"%s\" L:\"%s\"",
+            hashesPerSec,
+            hps_ch.c_str(),
+            cracked,
+            hashcount,
+            percent,
+            wordsProcessed,
+            m_Metrics.GetQueueDepth(),
+            printable_cracked.c_str(),
+            printable_last.c_str()
+    );
+    if (count < m_TerminalWidth - 1)
+    {
+        statusbuf[count] = ' ';
+    }
+    fprintf(stderr, "%s", statusbuf);
+}
+
+const bool
+CrackList::WriteStatusJson(
+    const double HashesPerSec
+)
+{
+    size_t cracked;
+    {
+        std::lock_guard<std::mutex> lock(m_ResultsMutex);
+        cracked = m_Cracked;
+    }
+
+    std::ostringstream json;
+    json << "{\"elapsed_ms\":" << m_Metrics.GetElapsedMs();
+    json << ",\"hashes_per_sec\":" << (uint64_t)HashesPerSec;
+    json << ",\"words_read\":" << m_WordsProcessed;
+    json << ",\"candidates\":" << m_Metrics.GetCandidates();
+    json << ",\"blocks\":" << m_BlocksProcessed;
+    json << ",\"cracked\":" << cracked;
+    json << ",\"targets\":" << m_Count;
+    json << ",\"complete\":" << (m_Complete ? "true" : "false") << ",";
+    m_Metrics.WriteJson(json);
+    json << "}\n";
+
+    // Replace the file whole so a scraper never sees a partial write
+    std::filesystem::path temporary = m_StatusJson;
+    temporary += ".tmp";
+    std::ofstream output(temporary, std::ios::out | std::ios::trunc);
+    output << json.str();
+    output.close();
+    if (!output)
+    {
+        std::cerr << "Error: unable to write status to " << temporary << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, m_StatusJson, error);
+    if (error)
+    {
+        std::cerr << "Error: unable to replace " << m_StatusJson << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void
+CrackList::InitializeNuma(
+    void
+)
+{
+    if (!m_Topology.Detect())
+    {
+        std::cerr << "Unable to read NUMA topology, pinning to all CPUs" << std::endl;
+    }
+
+    const size_t nodes = m_Topology.GetNodeCount();
+    std::cerr << "NUMA nodes: " << nodes << std::endl;
+
+    if (nodes == 1)
+    {
+        return;
+    }
+
+    // Each copy is made by a thread bound to its node so first
+    // touch places it in that node's memory
+    m_HashList.WaitForIndex();
+    auto start = std::chrono::system_clock::now();
+    std::vector<std::thread> copiers;
+    for (size_t i = 0; i < nodes; i++)
+    {
+        m_Replicas.push_back(std::make_unique<HashList>());
+    }
+    for (size_t i = 0; i < nodes; i++)
+    {
+        copiers.emplace_back([this, i]{
+            Topology::PinThread(m_Topology.GetNode(i).Cpus);
+            m_HashList.Replicate(*m_Replicas[i]);
+        });
+    }
+    for (auto& copier : copiers)
+    {
+        copier.join();
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+    std::cerr << "Replicated hash list to " << nodes << " nodes in " << elapsed_ms.count() << "ms" << std::endl;
+}
+
+void
+CrackList::ProcessBlock(
+    const size_t Worker,
+    InputBlock& Block
+)
+{
+    if (m_Complete || s_Interrupted)
+    {
+        m_Pool->Cancel();
+        return;
+    }
+
+    const size_t node = m_Numa ? m_Topology.WorkerNode(Worker) : 0;
+    ThreadMetrics* const metrics = m_Metrics.GetWorker(Worker);
+    std::vector<CrackResult> cracked;
+
+    CrackBlock(m_Replicas.empty() ? m_HashList : *m_Replicas[node], Block.Words, cracked, true, metrics);
+
+    if (!cracked.empty())
+    {
+        StageTimer timer(metrics, StageOutput);
+        std::unique_lock<std::mutex> lock(m_ResultsMutex, std::defer_lock);
+        {
+            TRACE_SPAN("output wait");
+            lock.lock();
+        }
+        TRACE_SPAN("output");
+        OutputResultsInternal(cracked);
+    }
+
+    m_BlocksProcessed++;
+    // Only once the hits are written can the block be checkpointed
+    m_Checkpoint.Complete(Block.Sequence, Block.End, Block.Words.size());
+
+    if (m_Complete)
+    {
+        m_Pool->Cancel();
+    }
+}
+
+const bool
+CrackList::CrackThreaded(
+    void
+)
+{
+    std::cerr << "Performing threaded crack with " << m_Threads << " threads" << std::endl;
+
+    m_Metrics.Reset(m_Threads);
+    m_Pool = std::make_unique<WorkStealingPool<InputBlock>>();
+    m_Pool->SetCapacity(m_CacheSizeBlocks);
+
+    if (m_Numa)
+    {
+        InitializeNuma();
+
+        std::vector<size_t> groups;
+        for (size_t i = 0; i < m_Threads; i++)
+        {
+            groups.push_back(m_Topology.WorkerNode(i));
+        }
+        m_Pool->SetGroups(groups);
+    }
+
+    m_Pool->SetStartHandler([this](const size_t Worker) {
+        TRACE_THREAD("worker", Worker);
+        if (m_Numa && !Topology::PinThread({m_Topology.WorkerCpu(Worker)}))
+        {
+            std::cerr << "Warning: unable to pin worker " << Worker << std::endl;
+        }
+    });
+
+    m_Pool->Start(m_Threads, [this](const size_t Worker, InputBlock& Block) {
+        ProcessBlock(Worker, Block);
+    });
+
+    StartStatus();
+
+    // This thread reads the input
+    TRACE_THREAD("reader", 0);
+    ThreadMetrics* const reader = m_Metrics.GetReader();
+    while (!m_Exhausted && !m_Complete && !s_Interrupted)
+    {
+        std::vector<std::string> block;
+        {
+            StageTimer timer(reader, StageRead);
+            TRACE_SPAN("read");
+            block = ReadBlock();
+        }
+
+        // Can be empty if the input is blocksize aligned
+        if (block.empty())
+        {
+            continue;
+        }
+
+        if (!m_Pool->Push({m_NextSequence++, m_ReadOffset, std::move(block)}))
+        {
+            break;
+        }
+    }
+
+    if (s_Interrupted)
+    {
+        m_Pool->Cancel();
+    }
+    else
+    {
+        m_Pool->Close();
+    }
+    m_Pool->Wait();
+    StopStatus();
+    m_Pool.reset();
+
+    return true;
+}
+
+const double
+CrackList::BenchmarkRun(
+    HashList& List,
+    const std::vector<std::vector<std::string>>& Blocks,
+    const size_t Threads
+)
+{
+    std::atomic<bool> stop = false;
+    std::atomic<size_t> hashed = 0;
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < Threads; t++)
+    {
+        workers.emplace_back([&, t]{
+            size_t count = 0;
+            // Hits are reported every time so each pass does the same work
+            std::vector<CrackResult> results;
+            for (size_t i = t % Blocks.size(); !stop; i = (i + Threads) % Blocks.size())
+            {
+                CrackBlock(List, Blocks[i], results, false);
+                count += Blocks[i].size();
+                results.clear();
+            }
+            hashed += count;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(BENCHMARK_RUN_MS));
+    stop = true;
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    return elapsedUs ? (double)hashed * 1000000 / elapsedUs : 0;
+}
+
+const bool
+CrackList::Benchmark(
+    void
+)
+{
+    std::vector<HashAlgorithm> algorithms = {HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256, HashAlgorithmNTLM};
+    if (m_Algorithm != HashAlgorithmUndefined)
+    {
+        algorithms = {m_Algorithm};
+    }
+
+    // Powers of two up to the thread count, or every core
+    const size_t maxThreads = m_Threads > 1 ? m_Threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::vector<size_t> blockSizes = {1024, DEFAULT_BLOCK_SIZE, 65536};
+    if (m_BlockSize != 0)
+    {
+        blockSizes = {m_BlockSize};
+    }
+    for (auto& blockSize : blockSizes)
+    {
+        blockSize = (blockSize + CpuFeatures::Lanes() - 1) / CpuFeatures::Lanes() * CpuFeatures::Lanes();
+    }
+
+    std::cerr << "CPU: " << CpuFeatures::IsaLevelToString(CpuFeatures::Detect()) << ", " << CpuFeatures::Lanes() << " SIMD lanes" << std::endl;
+    std::cerr << "Generating " << BENCHMARK_CANDIDATES << " candidates" << std::endl;
+
+    // Fixed seed so every run measures the same input
+    std::mt19937_64 random(0);
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::uniform_int_distribution<size_t> length(6, 14);
+    std::vector<std::string> candidates(BENCHMARK_CANDIDATES);
+    for (auto& candidate : candidates)
+    {
+        candidate.resize(length(random));
+        for (auto& c : candidate)
+        {
+            c = alphabet[random() % (sizeof(alphabet) - 1)];
+        }
+    }
+
+    printf("%-8s %8s %8s %12s %9s\n", "Hash", "Threads", "Block", "H/s", "Scaling");
+    for (const HashAlgorithm algorithm : algorithms)
+    {
+        m_Algorithm = algorithm;
+        m_DigestLength = GetHashWidth(algorithm);
+
+        // Random targets plus the digests of some of the candidates,
+        // page aligned like a mapped hash file
+        const size_t targetsSize = BENCHMARK_TARGETS * m_DigestLength;
+        uint8_t* const targets = (uint8_t*)mmap(nullptr, targetsSize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (targets == MAP_FAILED)
+        {
+            std::cerr << "Error: unable to allocate benchmark targets" << std::endl;
+            return false;
+        }
+        std::generate(targets, targets + targetsSize, [&]{ return (uint8_t)random(); });
+        std::array<uint8_t, MAX_HASH_SIZE> digest;
+        for (size_t i = 0; i < BENCHMARK_TARGETS && i * BENCHMARK_HIT_RATE < candidates.size(); i++)
+        {
+            const std::string& candidate = candidates[i * BENCHMARK_HIT_RATE];
+            DoHash(algorithm, (const uint8_t*)candidate.data(), candidate.size(), &digest[0]);
+            memcpy(&targets[i * m_DigestLength], &digest[0], m_DigestLength);
+        }
+
+        HashList list;
+        list.SetBitmaskSize(m_BitmaskSize);
+        list.SetCompressed(m_Compressed);
+        if (!list.Initialize(targets, targetsSize, m_DigestLength, true))
+        {
+            munmap(targets, targetsSize);
+            return false;
+        }
+
+        for (const size_t blockSize : blockSizes)
+        {
+            // Full blocks taken round the candidates, at least one
+            // per thread so none of them sits idle
+            const size_t blockCount = std::max((candidates.size() + blockSize - 1) / blockSize, maxThreads);
+            std::vector<std::vector<std::string>> blocks(blockCount);
+            for (size_t b = 0; b < blockCount; b++)
+            {
+                blocks[b].reserve(blockSize);
+                for (size_t i = 0; i < blockSize; i++)
+                {
+                    blocks[b].push_back(candidates[(b * blockSize + i) % candidates.size()]);
+                }
+            }
+
+            // Scaling is relative to perfect scaling of one thread
+            double single = 0;
+            for (const size_t threads : threadCounts)
+            {
+                const double hashesPerSec = BenchmarkRun(list, blocks, threads);
+                if (threads == 1)
+                {
+                    single = hashesPerSec;
+                }
+
+                std::string factor;
+                const double scaled = Util::NumFactor(hashesPerSec, factor);
+                const double scaling = single != 0 ? hashesPerSec * 100 / (single * threads) : 0;
+                printf("%-8s %8zu %8zu %10.2lf%s %8.1lf%%\n", HashAlgorithmToString(algorithm), threads, blockSize, scaled, factor.c_str(), scaling);
+                fflush(stdout);
+            }
+        }
+
+        munmap(targets, targetsSize);
+    }
+
+    return true;
+}
+
+const bool
+CrackList::ParseWord(
+    std::string& Line
+) const
+{
+    // Strip carriage return if present at the end
+    if (!Line.empty() && Line.back() == '\r')
+    {
+        Line.pop_back();
+    }
+
+    if (Line.empty())
+    {
+        return false;
+    }
+
+    // Handle parsing "$HEX[]" input.
+    if (m_ParseHexInput && Line.starts_with("$HEX[") && Line.back() == ']')
+    {
+        auto bytes = Util::ParseHex(Line.substr(5, Line.size() - 6));
+        Line = std::string(bytes.begin(), bytes.end());
+    }
+
+    return true;
+}
+
+std::vector<std::string>
+CrackList::ReadBlock(
+    void
+)
+{
+    std::istream& input = m_WordlistFileStream.is_open() ? m_WordlistFileStream : std::cin;
+    std::vector<std::string> block;
+    std::string line;
+
+    block.reserve(m_BlockSize);
+
+    // Candidates were parsed and deduplicated when compiled
+    while (m_CompiledWordlist.IsOpen() && block.size() < m_BlockSize)
+    {
+        if (m_ReadOffset >= m_EndOffset || !m_CompiledWordlist.Read(m_ReadOffset, line))
+        {
+            m_Exhausted = true;
+            break;
+        }
+
+        block.push_back(std::move(line));
+        m_WordsProcessed++;
+    }
+
+    // Loop until the block is full or the input is exhausted
+    while(!m_CompiledWordlist.IsOpen() && block.size() < m_BlockSize)
+    {
+        if (input.eof() || m_ReadOffset >= m_EndOffset)
+        {
+            m_Exhausted = true;
+            break;
+        }
+
+        std::getline(input, line);
+        m_ReadOffset += line.size() + 1;
+
+        if (!ParseWord(line) || line == m_LastLine)
+        {
+            continue;
+        }
+
+        m_LastLine = line;
+        block.push_back(std::move(line));
+        m_WordsProcessed++;
+    }
+
+    if (!block.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_StatusMutex);
+        m_LastTry = block.back();
+    }
+
+    return block;
+}
+
+const bool
+CrackList::InitializeParsed(
+    const bool Sort
+)
+{
+    if (!m_Compressed)
+    {
+        return m_HashList.Initialize(&m_Hashes[0], m_Hashes.size(), m_DigestLength, Sort);
+    }
+
+    // A compressed list only keeps the leading bits of each digest in
+    // memory and confirms hits against the full digests. Those are
+    // written sorted to an unlinked temporary file and mapped like a
+    // binary hash file, so only the pages holding hits stay resident
+    HashList::Sort(&m_Hashes[0], m_Hashes.size() / m_DigestLength, m_DigestLength);
+
+    std::string path = (std::filesystem::temp_directory_path() / "cracklist-XXXXXX").string();
+    const int fd = mkstemp(&path[0]);
+    if (fd < 0)
+    {
+        std::cerr << "Error: unable to create temporary file " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    FILE* handle = fdopen(fd, "wb");
+    const bool written = fwrite(&m_Hashes[0], 1, m_Hashes.size(), handle) == m_Hashes.size();
+    if (fclose(handle) != 0 || !written)
+    {
+        std::cerr << "Error: failed writing temporary file " << path << std::endl;
+        std::filesystem::remove(path);
+        return false;
+    }
+    m_Hashes = std::vector<uint8_t>();
+
+    const bool success = m_HashList.Initialize(path, m_DigestLength, false);
+    std::filesystem::remove(path);
+    return success;
+}
+
+const bool
+CrackList::LoadHashList(
+    void
+)
+{
+    // Shared segments are keyed on the resolved hash file
+    const std::string source = std::filesystem::exists(m_HashFile) ?
+        std::filesystem::canonical(m_HashFile).string() : m_HashFile;
+
+    if (!m_SharedName.empty())
+    {
+        if (m_SortMerge || m_Compressed)
+        {
+            std::cerr << "Error: shared hash lists cannot be used with sort-merge or compressed mode" << std::endl;
+            return false;
+        }
+
+        if (m_HugePages)
+        {
+            std::cerr << "Error: use a hugetlbfs path for --shm rather than --hugepages" << std::endl;
+            return false;
+        }
+
+        // Reuse a hash list another process has already published
+        uint32_t algorithm = m_Algorithm;
+        if (m_HashList.Attach(m_SharedName, source, algorithm))
+        {
+            m_Algorithm = (HashAlgorithm)algorithm;
+            m_DigestLength = GetHashWidth(m_Algorithm);
+            m_Count = m_HashList.GetUniqueCount();
+            return true;
+        }
+        else if (HashList::SharedExists(m_SharedName))
+        {
+            return false;
+        }
+    }
+
+    // Detect the input type
+    if (m_HashType == InputTypeUnknown)
+    {
+        if (m_HashFile.ends_with(".txt") || m_HashFile.ends_with(".lst"))
+        {
+            m_HashType = InputTypeText;
+        }
+        else if (m_HashFile.ends_with(".bin") || m_HashFile.ends_with(".dat"))
+        {
+            m_HashType = InputTypeBinary;
+        }
+        else if (Util::IsHex(m_HashFile))
+        {
+            m_HashType = InputTypeSingle;
+        }
+        else
+        {
+            std::cerr << "Error: Unable to determine input hash file type" << std::endl;
+            return false;
         }
     }
 
     m_HashList.SetBitmaskSize(m_BitmaskSize);
+    m_HashList.SetCompressed(m_Compressed);
+    m_HashList.SetHugePages(m_HugePages && !m_SortMerge);
+    m_HashList.SetLazyIndex(m_LazyIndex);
+
+    // Open the hash file
+    if (m_HashType == InputTypeBinary)
+    {
+        if (m_Algorithm == HashAlgorithmUndefined)
+        {
+            std::cerr << "Error: binary hash list with no algorithm" << std::endl;
+            return false;
+        }
+
+        m_DigestLength = GetHashWidth(m_Algorithm);
+        if (m_SortMerge)
+        {
+            // The target list is only ever streamed so we
+            // don't map or index it
+            const size_t size = std::filesystem::file_size(m_HashFile);
+            if (size % m_DigestLength != 0)
+            {
+                std::cerr << "Error: length of hash file does not match digest" << std::endl;
+                return false;
+            }
+            m_Count = size / m_DigestLength;
+        }
+        else
+        {
+            m_HashList.SetMaxSize(m_HashFileLimit);
+            if (!m_HashList.Initialize(m_HashFile, m_DigestLength))
+            {
+                return false;
+            }
+        }
+        m_HashFileOffset = m_HashList.GetCount() * m_DigestLength;
+    }
+    else if (m_HashType == InputTypeText)
+    {
+        std::cerr << "Parsing hash list" << std::endl;
+
+        std::ifstream infile(m_HashFile);
+        std::string line;
+        while (m_HashFileOffset < m_HashFileLimit && std::getline(infile, line))
+        {
+            // A final line without a newline may still be being
+            // written, so it is left for the watcher
+            if (infile.eof() && m_Watch)
+            {
+                break;
+            }
+            m_HashFileOffset += line.size() + 1;
+
+            if (m_Algorithm == HashAlgorithmUndefined)
+            {
+                m_Algorithm = DetectHashAlgorithmHex(line.size());
+                if (m_Algorithm == HashAlgorithmUndefined)
+                {
+                    std::cerr << "Unable to detect hash algorithm" << std::endl;
+                    return false;
+                }
+                std::cerr << HashAlgorithmToString(m_Algorithm) << " detected" << std::endl;
+                m_DigestLength = GetHashWidth(m_Algorithm);
+            }
+            else
+            {
+                m_DigestLength = GetHashWidth(m_Algorithm);
+            }
+            if (line.size() != m_DigestLength * 2)
+            {
+                std::cerr << "Invalid hash found, ignoring " << line.size() << "!=" << m_DigestLength * 2 << ": \"" << line << "\"" << std::endl;
+                continue;
+            }
+
+            // Add the new hash to the list
+            auto bytes = Util::ParseHex(line);
+            m_Hashes.insert(m_Hashes.end(), bytes.begin(), bytes.end());
+        }
+
+        if (!InitializeParsed(true))
+        {
+            return false;
+        }
+    }
+    else if (m_HashType == InputTypeSingle)
+    {
+        m_Algorithm = DetectHashAlgorithmHex(m_HashFile.size());
+        if (m_Algorithm == HashAlgorithmUndefined)
+        {
+            std::cerr << "Unable to detect hash algorithm" << std::endl;
+            return false;
+        }
+        m_DigestLength = GetHashWidth(m_Algorithm);
+        std::cerr << HashAlgorithmToString(m_Algorithm) << " detected" << std::endl;
+        // Add the new hash to the list
+        auto bytes = Util::ParseHex(m_HashFile);
+        m_Hashes.insert(m_Hashes.end(), bytes.begin(), bytes.end());
+        if (!InitializeParsed(false))
+        {
+            return false;
+        }
+    }
+
+    if (m_SortMerge && m_HashType != InputTypeBinary)
+    {
+        std::cerr << "Error: sort-merge mode requires a sorted binary hash file" << std::endl;
+        return false;
+    }
+
+    if (!m_SortMerge)
+    {
+        m_Count = m_HashList.GetUniqueCount();
+    }
+
+    if (m_DedupBytes != 0 && !m_Seen)
+    {
+        m_Seen = std::make_unique<SeenFilter>(m_DedupBytes);
+        std::cerr << "Duplicate filter: " << m_Seen->GetSizeBytes() / (1024 * 1024) << "MB" << std::endl;
+    }
+
+    // The huge page copy replaces our own
+    if (m_HashList.IsHugePageBacked())
+    {
+        m_Hashes = std::vector<uint8_t>();
+    }
+
+    if (!m_SharedName.empty())
+    {
+        if (!m_HashList.Publish(m_SharedName, source, m_Algorithm))
+        {
+            return false;
+        }
+        // The shared copy replaces our own
+        if (m_HashList.IsShared())
+        {
+            m_Hashes = std::vector<uint8_t>();
+        }
+    }
+
+    return true;
+}
+
+const size_t
+CrackList::LoadAppended(
+    void
+)
+{
+    std::error_code error;
+    const uint64_t size = std::filesystem::file_size(m_HashFile, error);
+    if (error || size <= m_HashFileOffset)
+    {
+        return 0;
+    }
+
+    std::ifstream input(m_HashFile, std::ios::in | std::ios::binary);
+    input.seekg(m_HashFileOffset);
+    std::string data(size - m_HashFileOffset, '\0');
+    input.read(&data[0], data.size());
+    data.resize(input.gcount());
+
+    std::vector<uint8_t> digests;
+    if (m_HashType == InputTypeBinary)
+    {
+        // Only whole digests, the rest is read once it is complete
+        data.resize(data.size() / m_DigestLength * m_DigestLength);
+        digests.assign(data.begin(), data.end());
+        m_HashFileOffset += data.size();
+    }
+    else
+    {
+        // Only complete lines, a partial line is read again later
+        const size_t end = data.rfind('\n');
+        if (end == std::string::npos)
+        {
+            return 0;
+        }
+        data.resize(end + 1);
+        m_HashFileOffset += data.size();
+
+        std::istringstream lines(data);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (line.size() != m_DigestLength * 2 || !Util::IsHex(line))
+            {
+                continue;
+            }
+            auto bytes = Util::ParseHex(line);
+            digests.insert(digests.end(), bytes.begin(), bytes.end());
+        }
+    }
 
-    // Open the hash file
-    if (m_HashType == InputTypeBinary)
+    // Targets already in the main list are tracked there
+    std::vector<uint8_t> fresh;
+    for (size_t i = 0; i < digests.size(); i += m_DigestLength)
     {
-        if (m_Algorithm == HashAlgorithmUndefined)
+        if (m_HashList.Lookup(&digests[i]) == HASH_NOT_FOUND)
         {
-            std::cerr << "Error: binary hash list with no algorithm" << std::endl;
-            return false;
+            fresh.insert(fresh.end(), digests.begin() + i, digests.begin() + i + m_DigestLength);
         }
+    }
 
-        m_DigestLength = GetHashWidth(m_Algorithm);
-        m_HashList.Initialize(m_HashFile, m_DigestLength);
+    const size_t added = m_Delta->Add(fresh.data(), fresh.size() / m_DigestLength);
+    if (added != 0)
+    {
+        std::lock_guard<std::mutex> lock(m_ResultsMutex);
+        m_Count += added;
+        std::cerr << "\rLoaded " << added << " new targets from " << m_HashFile << std::endl;
     }
-    else if (m_HashType == InputTypeText)
+    return added;
+}
+
+void
+CrackList::WatchHashFile(
+    std::stop_token Stop
+)
+{
+    TRACE_THREAD("watcher", 0);
+
+    int notify = -1;
+#ifdef __linux__
+    notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify >= 0 && inotify_add_watch(notify, m_HashFile.c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0)
     {
-        std::cerr << "Parsing hash list" << std::endl;
+        close(notify);
+        notify = -1;
+    }
+#endif
+    if (notify < 0)
+    {
+        std::cerr << "Warning: unable to watch " << m_HashFile << ", polling instead" << std::endl;
+    }
 
-        std::ifstream infile(m_HashFile);
-        std::string line;
-        while (std::getline(infile, line))
+    // Anything past the loaded prefix, such as after a restore
+    LoadAppended();
+
+    while (!Stop.stop_requested())
+    {
+        if (notify >= 0)
         {
-            if (m_Algorithm == HashAlgorithmUndefined)
+            struct pollfd event = {notify, POLLIN, 0};
+            if (poll(&event, 1, WATCH_POLL_MS) > 0)
             {
-                m_Algorithm = DetectHashAlgorithmHex(line.size());
-                if (m_Algorithm == HashAlgorithmUndefined)
-                {
-                    std::cerr << "Unable to detect hash algorithm" << std::endl;
-                    return false;
-                }
-                std::cerr << HashAlgorithmToString(m_Algorithm) << " detected" << std::endl;
-                m_DigestLength = GetHashWidth(m_Algorithm);
+                // The events only wake us, the file size says what changed
+                char buffer[4096];
+                while (read(notify, buffer, sizeof(buffer)) > 0);
             }
-            else
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(WATCH_POLL_MS));
+        }
+
+        if (!Stop.stop_requested() && LoadAppended() != 0)
+        {
+            TRACE_SPAN("compact");
+            m_Delta->Compact();
+        }
+    }
+
+    if (notify >= 0)
+    {
+        close(notify);
+    }
+}
+
+const uint64_t
+CrackList::ConfigHash(
+    void
+) const
+{
+    // Everything that changes which candidates map to which targets
+    std::string config = m_HashFile;
+    if (std::filesystem::exists(m_HashFile))
+    {
+        config = std::filesystem::canonical(m_HashFile).string();
+        // A watched file grows, only the part loaded at startup counts
+        config += ":" + std::to_string(m_Watch ? m_HashFileOffset : std::filesystem::file_size(m_HashFile));
+    }
+    config += ":" + std::filesystem::canonical(m_Wordlist).string();
+    config += ":" + std::to_string(std::filesystem::file_size(m_Wordlist));
+    config += ":" + std::to_string(m_Algorithm);
+    config += ":" + std::to_string(m_HashList.GetCount());
+    config += ":" + std::to_string(m_LinkedIn);
+    config += ":" + std::to_string(m_ParseHexInput);
+    config += ":" + std::to_string(m_EndOffset);
+
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const unsigned char c : config)
+    {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+const bool
+CrackList::InitializeRange(
+    void
+)
+{
+    if (m_Wordlist == "-" || m_Wordlist == "")
+    {
+        std::cerr << "Error: --skip, --limit and --slice require a wordlist file" << std::endl;
+        return false;
+    }
+
+    const bool compiled = m_CompiledWordlist.IsOpen();
+    const uint64_t size = compiled ? m_CompiledWordlist.GetDataEnd() : std::filesystem::file_size(m_Wordlist);
+    uint64_t start = m_Skip;
+    uint64_t end = m_Limit == 0 ? size : m_Skip + m_Limit;
+
+    if (m_SliceCount != 0)
+    {
+        if (m_SliceIndex == 0 || m_SliceIndex > m_SliceCount)
+        {
+            std::cerr << "Error: slice must be between 1/" << m_SliceCount << " and " << m_SliceCount << "/" << m_SliceCount << std::endl;
+            return false;
+        }
+        // Slices divide the skip/limit range
+        const uint64_t length = std::min(end, size) - std::min(start, size);
+        end = start + (unsigned __int128)length * m_SliceIndex / m_SliceCount;
+        start = start + (unsigned __int128)length * (m_SliceIndex - 1) / m_SliceCount;
+    }
+
+    start = std::min(start, size);
+    m_EndOffset = std::min(end, size);
+
+    if (compiled)
+    {
+        // Compiled wordlists are split on block boundaries, found
+        // through the index rather than by scanning
+        start = m_CompiledWordlist.AlignToBlock(start);
+        m_EndOffset = m_CompiledWordlist.AlignToBlock(m_EndOffset);
+    }
+    // Move forward to the start of the first line that
+    // begins inside the range
+    else if (start > 0)
+    {
+        std::string partial;
+        m_WordlistFileStream.seekg(start - 1);
+        std::getline(m_WordlistFileStream, partial);
+        start = std::min(start + partial.size(), size);
+    }
+
+    m_ReadOffset = start;
+    m_WordlistFileStream.clear();
+    m_WordlistFileStream.seekg(m_ReadOffset);
+    if (m_ReadOffset >= m_EndOffset)
+    {
+        m_Exhausted = true;
+    }
+
+    std::cerr << "Processing wordlist bytes " << m_ReadOffset << " to " << m_EndOffset << std::endl;
+    return true;
+}
+
+const bool
+CrackList::InitializeCheckpoint(
+    void
+)
+{
+    if (m_Wordlist == "-" || m_Wordlist == "")
+    {
+        std::cerr << "Error: checkpointing requires a wordlist file" << std::endl;
+        return false;
+    }
+
+    if (m_SortMerge)
+    {
+        std::cerr << "Error: checkpointing is not supported in sort-merge mode" << std::endl;
+        return false;
+    }
+
+    m_Reported = std::make_unique<AtomicBitmap>(m_HashList.GetCount());
+    m_Checkpoint.SetConfigHash(ConfigHash());
+    m_Checkpoint.SetHashFileOffset(m_HashFileOffset);
+
+    if (m_Restore && std::filesystem::exists(m_Checkpoint.GetPath()))
+    {
+        if (!m_Checkpoint.Load(*m_Reported))
+        {
+            return false;
+        }
+
+        // Targets reported before the checkpoint stay cracked
+        AtomicBitmap& cracked = m_HashList.GetCracked();
+        for (size_t i = 0; i < m_Reported->GetWordCount(); i++)
+        {
+            const uint64_t word = m_Reported->GetWord(i);
+            cracked.SetWord(i, word);
+            m_Cracked += __builtin_popcountll(word);
+        }
+
+        m_ReadOffset = std::min<uint64_t>(m_Checkpoint.GetOffset(), std::filesystem::file_size(m_Wordlist));
+        m_WordsProcessed = m_Checkpoint.GetWords();
+        m_WordlistFileStream.clear();
+        m_WordlistFileStream.seekg(m_ReadOffset);
+        if (m_ReadOffset >= std::min<uint64_t>(m_EndOffset, std::filesystem::file_size(m_Wordlist)))
+        {
+            m_Exhausted = true;
+        }
+
+        std::cerr << "Resuming from byte " << m_ReadOffset << " with " << m_Cracked << " hashes cracked" << std::endl;
+
+        if (m_Cracked == m_Count)
+        {
+            m_Complete = true;
+        }
+    }
+
+    m_Checkpoint.Start(m_ReadOffset, m_WordsProcessed);
+
+    signal(SIGINT, Interrupt);
+    signal(SIGTERM, Interrupt);
+    return true;
+}
+
+void
+CrackList::SaveCheckpoint(
+    void
+)
+{
+    // Hold off output so the bitmap matches what has been written
+    std::lock_guard<std::mutex> lock(m_ResultsMutex);
+    std::ostream& output = m_OutputFileStream.is_open() ? m_OutputFileStream : std::cout;
+    output.flush();
+    m_Checkpoint.Save(*m_Reported);
+}
+
+void
+CrackList::ReportTlb(
+    const char* Phase,
+    const uint64_t Loads,
+    const uint64_t Misses,
+    const size_t Candidates
+) const
+{
+    std::cerr << "dTLB " << Phase << ": " << Misses << " misses / " << Loads << " loads";
+    if (Loads != 0)
+    {
+        std::cerr << " (" << (double)Misses * 100 / Loads << "%)";
+    }
+    if (Candidates != 0)
+    {
+        std::cerr << ", " << (double)Misses / Candidates << " misses per candidate";
+    }
+    std::cerr << std::endl;
+}
+
+const bool
+CrackList::Crack(
+    void
+)
+{
+    bool result = false;
+
+    // Check parameters
+    if (m_HashFile == "")
+    {
+        std::cerr << "Error: no hash file specified" << m_HashFile << std::endl;
+        return false;
+    }
+
+    // Open the input file
+    if (m_Wordlist != "-" && m_Wordlist != "")
+    {
+        if (!std::filesystem::exists(m_Wordlist))
+        {
+            std::cerr << "Error: Wordlist file does not exist" << std::endl;
+            return false;
+        }
+
+        if (CompiledWordlist::IsCompiled(m_Wordlist))
+        {
+            if (!m_CompiledWordlist.Open(m_Wordlist))
             {
-                m_DigestLength = GetHashWidth(m_Algorithm);
+                return false;
             }
-            if (line.size() != m_DigestLength * 2)
+
+            const WordlistHeader& header = m_CompiledWordlist.GetHeader();
+            std::cerr << "Compiled wordlist: " << header.WordCount << " candidates in " << header.BlockCount << " blocks" << std::endl;
+            if (m_ParseHexInput && !(header.Flags & WORDLIST_FLAG_HEX))
             {
-                std::cerr << "Invalid hash found, ignoring " << line.size() << "!=" << m_DigestLength * 2 << ": \"" << line << "\"" << std::endl;
-                continue;
+                std::cerr << "Warning: wordlist was compiled without --parse-hex, $HEX[] candidates are used as is" << std::endl;
             }
 
-            // Add the new hash to the list
-            auto bytes = Util::ParseHex(line);
-            m_Hashes.insert(m_Hashes.end(), bytes.begin(), bytes.end());
+            // Blocks are read whole unless a size was asked for
+            if (m_BlockSize == 0)
+            {
+                m_BlockSize = header.BlockSize;
+            }
+            m_ReadOffset = m_CompiledWordlist.GetDataStart();
+            m_EndOffset = m_CompiledWordlist.GetDataEnd();
+        }
+        else
+        {
+            m_WordlistFileStream.open(m_Wordlist, std::ios::in);
         }
+    }
 
-        m_HashList.Initialize(&m_Hashes[0], m_Hashes.size(), m_DigestLength, true);
+    m_BlockSize = GetBlockSize();
+    std::cerr << "CPU: " << CpuFeatures::IsaLevelToString(CpuFeatures::Detect()) << ", " << CpuFeatures::Lanes() << " SIMD lanes" << std::endl;
+
+    if (m_BlockSize % CpuFeatures::Lanes() != 0)
+    {
+        std::cerr << "Error: Block Size must be a multiple of Simd Lanes (" << CpuFeatures::Lanes() << ")" << std::endl;
+        return false;
     }
-    else if (m_HashType == InputTypeSingle)
+
+    if (m_OutFile != "")
     {
-        m_Algorithm = DetectHashAlgorithmHex(m_HashFile.size());
-        if (m_Algorithm == HashAlgorithmUndefined)
+        m_OutputFileStream.open(m_OutFile, std::ios::out | std::ios::app);
+    }
+
+    // Threads started from here on are counted as well
+    if (m_TlbStats &&
+        (!m_TlbLoads.Open(PERF_TYPE_HW_CACHE, PerfCounter::DtlbLoads()) ||
+         !m_TlbMisses.Open(PERF_TYPE_HW_CACHE, PerfCounter::DtlbMisses())))
+    {
+        std::cerr << "Warning: dTLB counters unavailable" << std::endl;
+    }
+
+    // Restore the hash list as it was, anything appended since is
+    // picked up by the watcher
+    CheckpointHeader checkpoint;
+    if (m_Watch && m_Restore && m_Checkpoint.ReadHeader(checkpoint))
+    {
+        m_HashFileLimit = checkpoint.HashFileOffset;
+    }
+
+    if (!LoadHashList())
+    {
+        return false;
+    }
+
+    const uint64_t startupLoads = m_TlbLoads.Read();
+    const uint64_t startupMisses = m_TlbMisses.Read();
+    if (m_TlbMisses.IsOpen())
+    {
+        ReportTlb("startup", startupLoads, startupMisses, 0);
+    }
+
+    if ((m_Skip != 0 || m_Limit != 0 || m_SliceCount != 0) && !InitializeRange())
+    {
+        return false;
+    }
+
+    if (!m_Checkpoint.GetPath().empty() && !InitializeCheckpoint())
+    {
+        return false;
+    }
+
+    if (m_Watch)
+    {
+        if (m_SortMerge || m_HashType == InputTypeSingle)
         {
-            std::cerr << "Unable to detect hash algorithm" << std::endl;
-            return false;
+            std::cerr << "Warning: --watch needs a hash file loaded in memory, ignoring" << std::endl;
+        }
+        else
+        {
+            m_Delta = std::make_unique<HashDelta>(m_DigestLength);
+            m_Watcher = std::jthread([this](std::stop_token Stop) { WatchHashFile(Stop); });
         }
-        m_DigestLength = GetHashWidth(m_Algorithm);
-        std::cerr << HashAlgorithmToString(m_Algorithm) << " detected" << std::endl;
-        // Add the new hash to the list
-        auto bytes = Util::ParseHex(m_HashFile);
-        m_Hashes.insert(m_Hashes.end(), bytes.begin(), bytes.end());
-        m_HashList.Initialize(&m_Hashes[0], m_Hashes.size(), m_DigestLength, false);
     }
 
-    m_Count = m_HashList.GetCount();
-
     std::cerr << "Beginning cracking" << std::endl;
     
-    if (m_Threads == 1)
+    if (m_SortMerge)
+    {
+        result = CrackMerge();
+    }
+    else if (m_Threads == 1)
     {
         result = CrackLinear();
     }
@@ -599,48 +1779,72 @@ CrackList::Crack(
             m_Threads = std::thread::hardware_concurrency();
         }
 
-        // Create our IO thread
-        m_IoThread = dispatch::CreateDispatcher(
-            "io",
-            dispatch::bind(
-                &CrackList::ReadInput,
-                this
-            )
-        );
+        result = CrackThreaded();
+    }
 
-        m_DispatchPool = dispatch::CreateDispatchPool("worker", m_Threads);
-        m_ActiveWorkers = m_Threads;
+    if (m_Watcher.joinable())
+    {
+        m_Watcher.request_stop();
+        m_Watcher.join();
+    }
 
-        for (size_t i = 0; i < m_Threads; i++)
+    // Terminate the status line
+    if (!m_OutFile.string().empty())
+    {
+        std::cerr << std::endl;
+    }
+
+    if (!m_Checkpoint.GetPath().empty())
+    {
+        SaveCheckpoint();
+        if (s_Interrupted)
         {
-            m_DispatchPool->PostTask(
-                dispatch::bind(
-                    &CrackList::CrackWorker,
-                    this,
-                    i
-                )
-            );
+            std::cerr << "Interrupted, checkpoint saved at byte " << m_Checkpoint.GetOffset() << std::endl;
         }
+    }
 
-        dispatch::CreateAndEnterDispatcher(
-            "main",
-            std::bind(
-                dispatch::DoNothing
-            )
-        );
-
-        result = true;
+    if (m_TlbMisses.IsOpen())
+    {
+        ReportTlb("cracking", m_TlbLoads.Read() - startupLoads, m_TlbMisses.Read() - startupMisses, m_WordsProcessed);
     }
 
-    // Terminate the status line
-    if (!m_OutFile.string().empty())
+    if (m_Seen)
     {
-        std::cerr << std::endl;
+        const size_t checked = m_DedupChecked;
+        const size_t skipped = m_DedupSkipped;
+        std::cerr << "Skipped   " << skipped << " duplicate inputs (";
+        std::cerr << (checked ? (double)skipped * 100 / checked : 0) << "%)" << std::endl;
     }
 
     std::cerr << "Processed " << m_WordsProcessed << " inputs" << std::endl;
     std::cerr << "Processed " << m_BlocksProcessed << " blocks" << std::endl;
     std::cerr << "Cracked   " << m_Cracked << " hashes" << std::endl;
 
+    if (result && !m_SortMerge && !m_LeftFile.empty())
+    {
+        result = m_HashList.ExportUncracked(m_LeftFile);
+    }
+
+    // Targets loaded while watching follow the main list
+    if (result && m_Delta && !m_LeftFile.empty())
+    {
+        FILE* handle = fopen(m_LeftFile.c_str(), "ab");
+        const size_t written = handle != nullptr ? m_Delta->ExportUncracked(handle, HashList::IsBinaryPath(m_LeftFile)) : 0;
+        if (handle == nullptr || fclose(handle) != 0)
+        {
+            std::cerr << "Error: failed writing " << m_LeftFile << std::endl;
+            result = false;
+        }
+        else
+        {
+            std::cerr << "Wrote " << written << " uncracked appended hashes to " << m_LeftFile << std::endl;
+        }
+    }
+
+    if (!m_TraceFile.empty())
+    {
+        Trace::Dump(m_TraceFile);
+    }
+
     return result;
 }
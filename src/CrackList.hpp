@@ -10,20 +10,29 @@
 #define CrackList_hpp
 
 #include <atomic>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <map>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 
-#include "DispatchQueue.hpp"
 #include "simdhash.h"
 
+#include "Checkpoint.hpp"
+#include "CompiledWordlist.hpp"
+#include "CpuFeatures.hpp"
+#include "HashDelta.hpp"
 #include "HashList.hpp"
+#include "Metrics.hpp"
+#include "PerfCounter.hpp"
+#include "SeenFilter.hpp"
+#include "Topology.hpp"
+#include "WorkStealingPool.hpp"
 
 typedef enum
 {
@@ -33,6 +42,20 @@ typedef enum
     InputTypeSingle
 } HashFileType;
 
+// Cracked digest, lowercase hex digest, printable plaintext and the
+// index of the target in the hash list (HASH_NOT_FOUND if appended)
+typedef std::tuple<std::vector<uint8_t>,std::string,std::string,size_t> CrackResult;
+
+// A block of candidates tagged with its position in the input
+typedef struct _InputBlock
+{
+    size_t Sequence;
+    uint64_t End;
+    std::vector<std::string> Words;
+} InputBlock;
+
+#define DEFAULT_BLOCK_SIZE (8192)
+
 class CrackList
 {
 public:
@@ -51,67 +74,186 @@ public:
     void SetAutohex(const bool Autohex) { m_Hexlify = Autohex; }
     void SetBitmaskSize(const size_t BitmaskSize) { m_BitmaskSize = BitmaskSize; }
     void SetLinkedIn(const bool LinkedIn) { m_LinkedIn = LinkedIn; }
+    void SetCompressed(const bool Compressed) { m_Compressed = Compressed; }
+    void SetSortMerge(const bool SortMerge) { m_SortMerge = SortMerge; }
+    void SetLeftFile(const std::filesystem::path LeftFile) { m_LeftFile = LeftFile; }
+    void SetSharedName(const std::string SharedName) { m_SharedName = SharedName; }
+    void SetMergeBatchSize(const size_t MergeBatchSize) { m_MergeBatchSize = MergeBatchSize; }
+    void SetCheckpointFile(const std::filesystem::path CheckpointFile) { m_Checkpoint.SetPath(CheckpointFile); }
+    void SetCheckpointInterval(const size_t Seconds) { m_Checkpoint.SetInterval(Seconds); }
+    void SetRestore(const bool Restore) { m_Restore = Restore; }
+    void SetSkip(const uint64_t Skip) { m_Skip = Skip; }
+    void SetLimit(const uint64_t Limit) { m_Limit = Limit; }
+    void SetSlice(const size_t Index, const size_t Count) { m_SliceIndex = Index; m_SliceCount = Count; }
+    void SetNuma(const bool Numa) { m_Numa = Numa; }
+    void SetHugePages(const bool HugePages) { m_HugePages = HugePages; }
+    void SetTlbStats(const bool TlbStats) { m_TlbStats = TlbStats; }
+    void SetDedupBytes(const size_t DedupBytes) { m_DedupBytes = DedupBytes; }
+    void SetLazyIndex(const bool LazyIndex) { m_LazyIndex = LazyIndex; }
+    void SetWatch(const bool Watch) { m_Watch = Watch; }
+    void SetStatusJson(const std::filesystem::path StatusJson) { m_StatusJson = StatusJson; }
+    void SetStatusInterval(const size_t Seconds) { m_StatusInterval = Seconds; }
+    void SetTraceFile(const std::filesystem::path TraceFile) { m_TraceFile = TraceFile; }
     const std::string GetHashFile(void) const { return m_HashFile; }
     const std::filesystem::path GetOutFile(void) const { return m_OutFile; }
     const std::string GetWordlist(void) const { return m_Wordlist; }
     const HashAlgorithm GetAlgorithm(void) const { return m_Algorithm; }
     const std::string GetSeparator(void) const { return m_Separator; }
     const size_t GetThreads(void) const { return m_Threads; }
-    const size_t GetBlockSize(void) const { return m_BlockSize; }
+    // Unless set, a multiple of the lanes of the selected SIMD width
+    const size_t GetBlockSize(void) const { return m_BlockSize != 0 ? m_BlockSize : (DEFAULT_BLOCK_SIZE + CpuFeatures::Lanes() - 1) / CpuFeatures::Lanes() * CpuFeatures::Lanes(); }
     const bool GetBinary(void) const { return m_HashType == InputTypeBinary; }
     const size_t GetTerminalWidth(void) const { return m_TerminalWidth; }
     const size_t GetBitmaskSize(void) const { return m_BitmaskSize; }
     const bool GetAutohex(void) const { return m_Hexlify; }
     const bool GetParseHexInput(void) const { return m_ParseHexInput; }
     const bool GetLinkedIn(void) const { return m_LinkedIn; }
+    const bool GetCompressed(void) const { return m_Compressed; }
+    const bool GetSortMerge(void) const { return m_SortMerge; }
+    const std::filesystem::path GetLeftFile(void) const { return m_LeftFile; }
+    const std::string GetSharedName(void) const { return m_SharedName; }
+    const size_t GetMergeBatchSize(void) const { return m_MergeBatchSize; }
+    const std::filesystem::path GetCheckpointFile(void) const { return m_Checkpoint.GetPath(); }
+    const bool GetRestore(void) const { return m_Restore; }
+    const uint64_t GetSkip(void) const { return m_Skip; }
+    const uint64_t GetLimit(void) const { return m_Limit; }
+    const bool GetNuma(void) const { return m_Numa; }
+    const bool GetHugePages(void) const { return m_HugePages; }
+    const bool GetTlbStats(void) const { return m_TlbStats; }
+    const size_t GetDedupBytes(void) const { return m_DedupBytes; }
+    const bool GetLazyIndex(void) const { return m_LazyIndex; }
+    const bool GetWatch(void) const { return m_Watch; }
+    const std::filesystem::path GetStatusJson(void) const { return m_StatusJson; }
+    const size_t GetStatusInterval(void) const { return m_StatusInterval; }
+    const std::filesystem::path GetTraceFile(void) const { return m_TraceFile; }
     const bool Crack(void);
     const bool CrackLinear(void);
+    const bool CrackMerge(void);
+    // Measures H/s on generated data across algorithms, thread
+    // counts and block sizes without any input files
+    const bool Benchmark(void);
+    const bool LoadHashList(void);
+    void CrackBlock(const std::vector<std::string>& Block, std::vector<CrackResult>& Results, const bool Unique = true);
+    const bool ParseWord(std::string& Line) const;
+    const size_t GetDigestLength(void) const { return m_DigestLength; }
+    const size_t GetUniqueCount(void) const { return m_Count; }
 private:
-    void CrackWorker(const size_t Id);
-    void ThreadPulse(const size_t ThreadId, const uint64_t BlockTime, const std::string LastCracked, const std::string LastTry);
-    void WorkerFinished(void);
-    void ReadInput(void);
+    // Words with a non-zero Skip entry are left unhashed
+    void HashBlock(const std::string* Words, const size_t Count, uint8_t* Digests, const uint8_t* Skip = nullptr, ThreadMetrics* Metrics = nullptr) const;
+    void CrackBlock(HashList& List, const std::vector<std::string>& Block, std::vector<CrackResult>& Results, const bool Unique, ThreadMetrics* Metrics = nullptr);
+    const bool CrackThreaded(void);
+    void ProcessBlock(const size_t Worker, InputBlock& Block);
+    const double BenchmarkRun(HashList& List, const std::vector<std::vector<std::string>>& Blocks, const size_t Threads);
+    void InitializeNuma(void);
+    void StartStatus(void);
+    void StopStatus(void);
+    void StatusWorker(void);
+    void PrintStatus(const double HashesPerSec);
+    const bool WriteStatusJson(const double HashesPerSec);
     std::vector<std::string> ReadBlock(void);
     const std::string Hexlify(const std::string& Value) const;
     void OutputResults(void);
-    void OutputResultsInternal(std::vector<std::tuple<std::vector<uint8_t>,std::string,std::string>>& Results);
+    void OutputResultsInternal(std::vector<CrackResult>& Results);
+    const uint64_t ConfigHash(void) const;
+    const bool InitializeCheckpoint(void);
+    const bool InitializeRange(void);
+    void SaveCheckpoint(void);
+    void ReportTlb(const char* Phase, const uint64_t Loads, const uint64_t Misses, const size_t Candidates) const;
+    void WatchHashFile(std::stop_token Stop);
+    const size_t LoadAppended(void);
+    const bool InitializeParsed(const bool Sort);
     bool m_Hexlify = true;
-    size_t m_BitmaskSize = 16;
+    size_t m_BitmaskSize = 0;
     std::vector<uint8_t> m_Hashes;
     std::string m_HashFile;
     HashFileType m_HashType = InputTypeUnknown;
     std::filesystem::path m_OutFile;
+    std::filesystem::path m_LeftFile;
+    std::string m_SharedName;
     std::string m_Wordlist;
     HashAlgorithm m_Algorithm = HashAlgorithmUndefined;
     size_t m_DigestLength;
     HashList m_HashList;
     std::ifstream m_WordlistFileStream;
+    // Used instead of the stream when the wordlist is compiled,
+    // offsets are then into the compiled file
+    CompiledWordlist m_CompiledWordlist;
     std::ofstream m_OutputFileStream;
     std::string m_Separator = ":";
     std::string m_LastLine;
     std::string m_LastCracked;
-    size_t m_Count;
+    // Unique targets, grows as appended targets are loaded
+    std::atomic<size_t> m_Count = 0;
     std::atomic<size_t> m_WordsProcessed = 0;
     std::atomic<size_t> m_BlocksProcessed = 0;
     size_t m_Cracked = 0;
     bool m_ParseHexInput = false;
     size_t m_TerminalWidth = 80;
     bool m_LinkedIn = false;
+    bool m_Compressed = false;
+    bool m_SortMerge = false;
+    bool m_HugePages = false;
+    // Start cracking while the bucket index is still being built
+    bool m_LazyIndex = true;
+    // Targets appended to the hash file while running are loaded
+    // into m_Delta, m_HashFileOffset is how much has been read
+    bool m_Watch = false;
+    std::unique_ptr<HashDelta> m_Delta;
+    uint64_t m_HashFileOffset = 0;
+    // Set from the checkpoint so a restore loads the same prefix
+    uint64_t m_HashFileLimit = UINT64_MAX;
+    std::jthread m_Watcher;
+    // Data TLB counters, read after loading and after cracking
+    bool m_TlbStats = false;
+    PerfCounter m_TlbLoads;
+    PerfCounter m_TlbMisses;
+    // Words already seen by any worker are not hashed again
+    size_t m_DedupBytes = 0;
+    std::unique_ptr<SeenFilter> m_Seen;
+    std::atomic<size_t> m_DedupChecked = 0;
+    std::atomic<size_t> m_DedupSkipped = 0;
+    size_t m_MergeBatchSize = 1 << 22;
+    // Checkpointing
+    Checkpoint m_Checkpoint;
+    bool m_Restore = false;
+    // Targets whose hits have been written to the output
+    std::unique_ptr<AtomicBitmap> m_Reported;
+    uint64_t m_ReadOffset = 0;
+    // Byte range of the wordlist to process, lines are
+    // owned by the range that contains their first byte
+    uint64_t m_Skip = 0;
+    uint64_t m_Limit = 0;
+    size_t m_SliceIndex = 0;
+    size_t m_SliceCount = 0;
+    uint64_t m_EndOffset = UINT64_MAX;
+    size_t m_NextSequence = 0;
     // Threading
-    std::mutex m_InputMutex;
     std::mutex m_ResultsMutex;
-    std::vector<std::tuple<std::vector<uint8_t>,std::string,std::string>> m_Results;
-    std::queue<std::vector<std::string>> m_InputCache;
+    std::vector<CrackResult> m_Results;
     size_t m_CacheSizeBlocks = 4096;
     bool m_Exhausted = false;
-    bool m_Finished = false;
+    // Set once every unique target has been cracked
+    std::atomic<bool> m_Complete = false;
     size_t m_Threads = 1;
-    dispatch::DispatcherBasePtr m_MainThread;
-    dispatch::DispatcherBasePtr m_IoThread;
-    dispatch::DispatcherPoolPtr m_DispatchPool;
-    size_t m_ActiveWorkers;
-    size_t m_BlockSize = 8192;
-    std::map<size_t, uint64_t> m_LastBlockMs;
+    bool m_Numa = false;
+    Topology m_Topology;
+    // Node local copies of m_HashList, one per node when there is
+    // more than one
+    std::vector<std::unique_ptr<HashList>> m_Replicas;
+    std::unique_ptr<WorkStealingPool<InputBlock>> m_Pool;
+    size_t m_BlockSize = 0;
+    // Status reporting, driven by its own thread
+    Metrics m_Metrics;
+    std::thread m_StatusThread;
+    std::mutex m_StatusMutex;
+    std::condition_variable m_StatusWake;
+    bool m_StatusStop = false;
+    // Last candidate read, guarded by m_StatusMutex
+    std::string m_LastTry;
+    std::filesystem::path m_StatusJson;
+    size_t m_StatusInterval = 5;
+    // Chrome trace written at exit when built with CRACKLIST_TRACE
+    std::filesystem::path m_TraceFile;
 };
 
 #endif //CrackList_hpp
\ No newline at end of file
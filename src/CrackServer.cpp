@@ -0,0 +1,372 @@
+//
+//  CrackServer.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <cerrno>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+#include "CrackServer.hpp"
+
+// Size of socket reads and writes
+#define SOCKET_BUFFER_SIZE (1024 * 1024)
+// Blocks a single job may have queued in the pool
+// before we stop reading from its socket
+#define MAX_OUTSTANDING_BLOCKS (64)
+
+static const bool
+SendAll(
+    const int Socket,
+    const char* Data,
+    size_t Length
+)
+{
+    while (Length > 0)
+    {
+        const ssize_t sent = send(Socket, Data, Length, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        Data += sent;
+        Length -= sent;
+    }
+    return true;
+}
+
+static const bool
+MakeAddress(
+    const std::filesystem::path SocketPath,
+    struct sockaddr_un& Address
+)
+{
+    memset(&Address, 0, sizeof(Address));
+    Address.sun_family = AF_UNIX;
+    if (SocketPath.string().size() >= sizeof(Address.sun_path))
+    {
+        std::cerr << "Error: socket path is too long" << std::endl;
+        return false;
+    }
+    strncpy(Address.sun_path, SocketPath.c_str(), sizeof(Address.sun_path) - 1);
+    return true;
+}
+
+void
+CrackServer::ProcessBlock(
+    ServerBlock& Block
+)
+{
+    const std::shared_ptr<ServerJob> Job = Block.Job;
+
+    // Hits are reported per job so the shared cracked state is
+    // not used to suppress them
+    std::vector<CrackResult> cracked;
+    m_Engine.CrackBlock(Block.Words, cracked, false);
+
+    if (!cracked.empty())
+    {
+        std::string output;
+        for (auto& [h,x,v,i] : cracked)
+        {
+            output += x + m_Engine.GetSeparator() + v + "\n";
+        }
+
+        std::lock_guard<std::mutex> lock(Job->WriteMutex);
+        SendAll(Job->Socket, output.data(), output.size());
+        Job->Hits += cracked.size();
+    }
+
+    std::lock_guard<std::mutex> lock(Job->StateMutex);
+    Job->Outstanding--;
+    Job->BlockDone.notify_all();
+}
+
+void
+CrackServer::PostBlock(
+    std::shared_ptr<ServerJob> Job,
+    std::vector<std::string>& Block
+)
+{
+    {
+        std::unique_lock<std::mutex> lock(Job->StateMutex);
+        Job->BlockDone.wait(lock, [&]{ return Job->Outstanding < MAX_OUTSTANDING_BLOCKS; });
+        Job->Outstanding++;
+        Job->Words += Block.size();
+    }
+
+    m_Pool->Push({Job, std::move(Block)});
+
+    Block = std::vector<std::string>();
+    Block.reserve(m_Engine.GetBlockSize());
+}
+
+void
+CrackServer::HandleClient(
+    std::shared_ptr<ServerJob> Job
+)
+{
+    std::cerr << "Job " << Job->Id << " started" << std::endl;
+
+    auto start = std::chrono::system_clock::now();
+
+    std::vector<char> buffer(SOCKET_BUFFER_SIZE);
+    std::vector<std::string> block;
+    std::string partial;
+    std::string last;
+    ssize_t received;
+
+    block.reserve(m_Engine.GetBlockSize());
+
+    while ((received = recv(Job->Socket, &buffer[0], buffer.size(), 0)) > 0)
+    {
+        const char* cursor = &buffer[0];
+        const char* const end = cursor + received;
+        while (cursor < end)
+        {
+            const char* newline = (const char*)memchr(cursor, '\n', end - cursor);
+            if (newline == nullptr)
+            {
+                // Carry the incomplete line into the next read
+                partial.append(cursor, end);
+                break;
+            }
+
+            std::string line = std::move(partial);
+            partial.clear();
+            line.append(cursor, newline);
+            cursor = newline + 1;
+
+            if (!m_Engine.ParseWord(line) || line == last)
+            {
+                continue;
+            }
+
+            last = line;
+            block.push_back(std::move(line));
+            if (block.size() == m_Engine.GetBlockSize())
+            {
+                PostBlock(Job, block);
+            }
+        }
+    }
+
+    if (m_Engine.ParseWord(partial) && partial != last)
+    {
+        block.push_back(std::move(partial));
+    }
+
+    if (!block.empty())
+    {
+        PostBlock(Job, block);
+    }
+
+    // Wait for the pool to finish this job's blocks
+    {
+        std::unique_lock<std::mutex> lock(Job->StateMutex);
+        Job->BlockDone.wait(lock, [&]{ return Job->Outstanding == 0; });
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+    std::cerr << "Job " << Job->Id << " finished: " << Job->Words << " inputs, " << Job->Hits << " cracked in " << elapsed_ms.count() << "ms" << std::endl;
+
+    // Nothing may touch the server once it is told this job is done
+    std::lock_guard<std::mutex> lock(m_JobsMutex);
+    close(Job->Socket);
+    m_Jobs.erase(Job->Id);
+    m_JobsDone.notify_all();
+}
+
+const bool
+CrackServer::Serve(
+    void
+)
+{
+    if (m_Engine.GetHashFile() == "")
+    {
+        std::cerr << "Error: no hash file specified" << std::endl;
+        return false;
+    }
+
+    if (m_Engine.GetBlockSize() % CpuFeatures::Lanes() != 0)
+    {
+        std::cerr << "Error: Block Size must be a multiple of Simd Lanes (" << CpuFeatures::Lanes() << ")" << std::endl;
+        return false;
+    }
+
+    if (m_Engine.GetSortMerge())
+    {
+        std::cerr << "Error: sort-merge mode cannot be served" << std::endl;
+        return false;
+    }
+
+    struct sockaddr_un address;
+    if (!MakeAddress(m_SocketPath, address))
+    {
+        return false;
+    }
+
+    if (!m_Engine.LoadHashList())
+    {
+        return false;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        std::cerr << "Error: unable to create socket" << std::endl;
+        return false;
+    }
+
+    // Remove a stale socket left by a previous server
+    unlink(m_SocketPath.c_str());
+
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+    {
+        std::cerr << "Error: unable to listen on " << m_SocketPath << ": " << strerror(errno) << std::endl;
+        close(listener);
+        return false;
+    }
+
+    size_t threads = m_Engine.GetThreads();
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    m_Pool = std::make_unique<WorkStealingPool<ServerBlock>>();
+    m_Pool->SetStartHandler([](const size_t Worker) {
+        TRACE_THREAD("worker", Worker);
+    });
+    m_Pool->Start(threads, [this](const size_t Worker, ServerBlock& Block) {
+        ProcessBlock(Block);
+    });
+
+    std::cerr << "Serving on " << m_SocketPath << " with " << threads << " threads" << std::endl;
+
+    while (true)
+    {
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Error: accept failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        auto job = std::make_shared<ServerJob>();
+        job->Socket = client;
+        job->Id = m_NextJob++;
+
+        {
+            std::lock_guard<std::mutex> lock(m_JobsMutex);
+            m_Jobs[job->Id] = client;
+        }
+        std::thread(&CrackServer::HandleClient, this, job).detach();
+    }
+
+    close(listener);
+
+    // Stop reading from every client and wait for their handlers to
+    // finish with the pool
+    {
+        std::unique_lock<std::mutex> lock(m_JobsMutex);
+        for (auto& [id, socket] : m_Jobs)
+        {
+            shutdown(socket, SHUT_RD);
+        }
+        m_JobsDone.wait(lock, [&]{ return m_Jobs.empty(); });
+    }
+
+    m_Pool->Close();
+    m_Pool->Wait();
+    m_Pool.reset();
+    return false;
+}
+
+const bool
+CrackServer::Submit(
+    const std::filesystem::path SocketPath,
+    const std::string Wordlist,
+    const std::filesystem::path OutFile
+)
+{
+    struct sockaddr_un address;
+    if (!MakeAddress(SocketPath, address))
+    {
+        return false;
+    }
+
+    int input = STDIN_FILENO;
+    if (Wordlist != "-" && Wordlist != "")
+    {
+        input = open(Wordlist.c_str(), O_RDONLY);
+        if (input < 0)
+        {
+            std::cerr << "Error: Wordlist file does not exist" << std::endl;
+            return false;
+        }
+    }
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || connect(server, (struct sockaddr*)&address, sizeof(address)) != 0)
+    {
+        std::cerr << "Error: unable to connect to " << SocketPath << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::ofstream outfile;
+    if (!OutFile.empty())
+    {
+        outfile.open(OutFile, std::ios::out | std::ios::app);
+    }
+    std::ostream& output = outfile.is_open() ? outfile : std::cout;
+
+    // Stream hits back while we are still sending candidates
+    std::thread receiver([&]{
+        std::vector<char> buffer(SOCKET_BUFFER_SIZE);
+        ssize_t received;
+        while ((received = recv(server, &buffer[0], buffer.size(), 0)) > 0)
+        {
+            output.write(&buffer[0], received);
+        }
+        output.flush();
+    });
+
+    std::vector<char> buffer(SOCKET_BUFFER_SIZE);
+    ssize_t count;
+    bool success = true;
+    while ((count = read(input, &buffer[0], buffer.size())) > 0)
+    {
+        if (!SendAll(server, &buffer[0], count))
+        {
+            std::cerr << "Error: connection to server lost" << std::endl;
+            success = false;
+            break;
+        }
+    }
+
+    // Signal the end of the job and wait for the remaining hits
+    shutdown(server, SHUT_WR);
+    receiver.join();
+    close(server);
+
+    if (input != STDIN_FILENO)
+    {
+        close(input);
+    }
+
+    return success;
+}
@@ -0,0 +1,71 @@
+//
+//  CrackServer.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef CrackServer_hpp
+#define CrackServer_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CrackList.hpp"
+#include "WorkStealingPool.hpp"
+
+typedef struct _ServerJob
+{
+    int Socket;
+    size_t Id;
+    std::mutex WriteMutex;
+    std::mutex StateMutex;
+    std::condition_variable BlockDone;
+    size_t Outstanding = 0;
+    size_t Words = 0;
+    std::atomic<size_t> Hits = 0;
+} ServerJob;
+
+typedef struct _ServerBlock
+{
+    std::shared_ptr<ServerJob> Job;
+    std::vector<std::string> Words;
+} ServerBlock;
+
+//
+// Keeps a loaded and indexed hash list resident and cracks
+// candidate streams submitted over a Unix domain socket. Every
+// connection is a job; its candidates are newline separated
+// and its hits are streamed back in the usual output format.
+//
+class CrackServer
+{
+public:
+    CrackServer(CrackList& Engine) : m_Engine(Engine) {};
+    void SetSocketPath(const std::filesystem::path SocketPath) { m_SocketPath = SocketPath; }
+    const std::filesystem::path GetSocketPath(void) const { return m_SocketPath; }
+    const bool Serve(void);
+    static const bool Submit(const std::filesystem::path SocketPath, const std::string Wordlist, const std::filesystem::path OutFile);
+private:
+    void HandleClient(std::shared_ptr<ServerJob> Job);
+    void PostBlock(std::shared_ptr<ServerJob> Job, std::vector<std::string>& Block);
+    void ProcessBlock(ServerBlock& Block);
+    CrackList& m_Engine;
+    std::filesystem::path m_SocketPath;
+    std::unique_ptr<WorkStealingPool<ServerBlock>> m_Pool;
+    std::atomic<size_t> m_NextJob = 0;
+    // Sockets of the jobs whose handlers are still running, so they
+    // can be stopped and drained before the pool goes away
+    std::mutex m_JobsMutex;
+    std::condition_variable m_JobsDone;
+    std::map<size_t, int> m_Jobs;
+};
+
+#endif //CrackServer_hpp
@@ -0,0 +1,200 @@
+//
+//  CrackSession.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <iostream>
+#include <string.h>
+#include <thread>
+
+#include "CrackSession.hpp"
+
+// Blocks that may be queued in the pool before Push blocks
+#define MAX_OUTSTANDING_BLOCKS (64)
+
+const bool
+CrackSession::Open(
+    void
+)
+{
+    if (m_Open)
+    {
+        return true;
+    }
+
+    if (m_Engine.GetBlockSize() % CpuFeatures::Lanes() != 0)
+    {
+        std::cerr << "Error: Block Size must be a multiple of Simd Lanes (" << CpuFeatures::Lanes() << ")" << std::endl;
+        return false;
+    }
+
+    if (m_Engine.GetSortMerge())
+    {
+        std::cerr << "Error: sort-merge mode cannot be used in a session" << std::endl;
+        return false;
+    }
+
+    if (!m_Engine.LoadHashList())
+    {
+        return false;
+    }
+
+    size_t threads = m_Engine.GetThreads();
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    m_Pool = std::make_unique<WorkStealingPool<std::vector<std::string>>>();
+    m_Pool->SetStartHandler([](const size_t Worker) {
+        TRACE_THREAD("session", Worker);
+    });
+    m_Pool->Start(threads, [this](const size_t Worker, std::vector<std::string>& Block) {
+        ProcessBlock(Block);
+    });
+    m_Open = true;
+    return true;
+}
+
+void
+CrackSession::ProcessBlock(
+    const std::vector<std::string>& Block
+)
+{
+    std::vector<CrackResult> cracked;
+    m_Engine.CrackBlock(Block, cracked);
+
+    if (!cracked.empty())
+    {
+        m_Hits += cracked.size();
+        if (m_HitCallback)
+        {
+            std::lock_guard<std::mutex> lock(m_CallbackMutex);
+            for (auto& result : cracked)
+            {
+                m_HitCallback(result);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_StateMutex);
+    m_Outstanding--;
+    m_BlockDone.notify_all();
+}
+
+void
+CrackSession::PostBlock(
+    std::vector<std::string>& Block
+)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_StateMutex);
+        m_BlockDone.wait(lock, [&]{ return m_Outstanding < MAX_OUTSTANDING_BLOCKS; });
+        m_Outstanding++;
+        m_Candidates += Block.size();
+    }
+
+    m_Pool->Push(std::move(Block));
+
+    Block = std::vector<std::string>();
+    Block.reserve(m_Engine.GetBlockSize());
+}
+
+const bool
+CrackSession::Push(
+    const char* Buffer,
+    const size_t Length
+)
+{
+    if (!m_Open)
+    {
+        std::cerr << "Error: session is not open" << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> block;
+    block.reserve(m_Engine.GetBlockSize());
+
+    const char* cursor = Buffer;
+    const char* const end = Buffer + Length;
+    while (cursor < end)
+    {
+        const char* newline = (const char*)memchr(cursor, '\n', end - cursor);
+        if (newline == nullptr)
+        {
+            newline = end;
+        }
+
+        std::string line(cursor, newline);
+        cursor = newline + 1;
+
+        if (!m_Engine.ParseWord(line))
+        {
+            continue;
+        }
+
+        block.push_back(std::move(line));
+        if (block.size() == m_Engine.GetBlockSize())
+        {
+            PostBlock(block);
+        }
+    }
+
+    if (!block.empty())
+    {
+        PostBlock(block);
+    }
+
+    return true;
+}
+
+const bool
+CrackSession::Push(
+    const std::vector<std::string>& Candidates
+)
+{
+    if (!m_Open)
+    {
+        std::cerr << "Error: session is not open" << std::endl;
+        return false;
+    }
+
+    const size_t blockSize = m_Engine.GetBlockSize();
+    for (size_t first = 0; first < Candidates.size(); first += blockSize)
+    {
+        const size_t last = std::min(first + blockSize, Candidates.size());
+        std::vector<std::string> block(Candidates.begin() + first, Candidates.begin() + last);
+        PostBlock(block);
+    }
+
+    return true;
+}
+
+void
+CrackSession::Flush(
+    void
+)
+{
+    std::unique_lock<std::mutex> lock(m_StateMutex);
+    m_BlockDone.wait(lock, [&]{ return m_Outstanding == 0; });
+}
+
+void
+CrackSession::Close(
+    void
+)
+{
+    if (!m_Open)
+    {
+        return;
+    }
+
+    Flush();
+    m_Pool->Close();
+    m_Pool->Wait();
+    m_Pool.reset();
+    m_Open = false;
+}
@@ -0,0 +1,64 @@
+//
+//  CrackSession.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef CrackSession_hpp
+#define CrackSession_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CrackList.hpp"
+#include "WorkStealingPool.hpp"
+
+typedef std::function<void(const CrackResult&)> HitCallback;
+
+//
+// Embeds the engine in another program. Targets are loaded once
+// by Open(), after which candidates are pushed in batches and
+// every newly cracked target is passed to the hit callback. The
+// callback is serialised but runs on the worker threads.
+//
+class CrackSession
+{
+public:
+    CrackSession(CrackList& Engine) : m_Engine(Engine) {};
+    ~CrackSession(void) { Close(); };
+    void SetHitCallback(HitCallback Callback) { m_HitCallback = Callback; }
+    const bool Open(void);
+    // Newline separated candidates; a trailing line without a newline is a candidate
+    const bool Push(const char* Buffer, const size_t Length);
+    // Candidates are used as is, without $HEX decoding
+    const bool Push(const std::vector<std::string>& Candidates);
+    // Waits for every pushed candidate to be processed
+    void Flush(void);
+    void Close(void);
+    const bool IsOpen(void) const { return m_Open; }
+    const bool IsComplete(void) const { return m_Hits == m_Engine.GetUniqueCount(); }
+    const size_t GetCandidates(void) const { return m_Candidates; }
+    const size_t GetHits(void) const { return m_Hits; }
+private:
+    void PostBlock(std::vector<std::string>& Block);
+    void ProcessBlock(const std::vector<std::string>& Block);
+    CrackList& m_Engine;
+    HitCallback m_HitCallback;
+    std::unique_ptr<WorkStealingPool<std::vector<std::string>>> m_Pool;
+    bool m_Open = false;
+    std::mutex m_CallbackMutex;
+    std::mutex m_StateMutex;
+    std::condition_variable m_BlockDone;
+    size_t m_Outstanding = 0;
+    size_t m_Candidates = 0;
+    std::atomic<size_t> m_Hits = 0;
+};
+
+#endif //CrackSession_hpp
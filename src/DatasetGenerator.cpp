@@ -0,0 +1,162 @@
+//
+//  DatasetGenerator.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <array>
+#include <iostream>
+#include <stdio.h>
+
+#include "Common.hpp"
+#include "DatasetGenerator.hpp"
+#include "Util.hpp"
+
+// Output files are written through buffers of this size
+#define GENERATE_BUFFER_SIZE (4 * 1024 * 1024)
+// Keeps the random targets apart from the word stream
+#define TARGET_STREAM (0x7461726765747321ull)
+
+// splitmix64, fully specified so the datasets are the
+// same on every platform and standard library
+static inline uint64_t
+SplitMix(
+    uint64_t& State
+)
+{
+    uint64_t z = (State += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+const std::string
+DatasetGenerator::Word(
+    const size_t Index
+) const
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    uint64_t state = m_Seed * 0x9e3779b97f4a7c15ull ^ Index;
+    uint64_t bits = SplitMix(state);
+
+    // A random prefix of 5 to 10 characters and the index in
+    // base 36, which keeps every word unique
+    std::string word;
+    const size_t length = 5 + bits % 6;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (i % 8 == 0)
+        {
+            bits = SplitMix(state);
+        }
+        word += alphabet[(bits >> (i % 8 * 8)) % 36];
+    }
+    word += '_';
+    size_t value = Index;
+    do
+    {
+        word += alphabet[value % 36];
+        value /= 36;
+    } while (value != 0);
+    return word;
+}
+
+const bool
+DatasetGenerator::Generate(
+    void
+)
+{
+    if (m_Output.empty())
+    {
+        std::cerr << "Error: no output directory specified" << std::endl;
+        return false;
+    }
+
+    const size_t words = m_Words != 0 ? m_Words : m_Targets;
+    const size_t hits = std::min({m_Hits != 0 ? m_Hits : std::min(m_Targets, words) / 2, m_Targets, words});
+    const size_t digestLength = GetHashWidth(m_Algorithm);
+
+    std::error_code error;
+    std::filesystem::create_directories(m_Output, error);
+    if (error)
+    {
+        std::cerr << "Error: unable to create " << m_Output << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    std::cerr << "Generating " << m_Targets << " " << HashAlgorithmToString(m_Algorithm) << " targets, ";
+    std::cerr << words << " words and " << hits << " hits with seed " << m_Seed << std::endl;
+
+    FILE* wordlist = fopen((m_Output / "words.txt").c_str(), "w");
+    FILE* targets = fopen((m_Output / "targets.txt").c_str(), "w");
+    FILE* expected = fopen((m_Output / "expected.txt").c_str(), "w");
+    if (wordlist == nullptr || targets == nullptr || expected == nullptr)
+    {
+        std::cerr << "Error: unable to open output files in " << m_Output << std::endl;
+        for (FILE* file : {wordlist, targets, expected})
+        {
+            if (file != nullptr)
+            {
+                fclose(file);
+            }
+        }
+        return false;
+    }
+    setvbuf(wordlist, nullptr, _IOFBF, GENERATE_BUFFER_SIZE);
+    setvbuf(targets, nullptr, _IOFBF, GENERATE_BUFFER_SIZE);
+
+    for (size_t i = 0; i < words; i++)
+    {
+        const std::string word = Word(i);
+        fwrite(word.data(), 1, word.size(), wordlist);
+        fputc('\n', wordlist);
+    }
+
+    // Hits are spread evenly through both files, the remaining
+    // targets are random digests that nothing will crack
+    const size_t wordStride = hits ? words / hits : 0;
+    const size_t targetStride = hits ? m_Targets / hits : 0;
+    std::array<uint8_t, MAX_HASH_SIZE> digest;
+    char hex[MAX_HASH_SIZE * 2 + 1];
+    hex[digestLength * 2] = '\n';
+
+    for (size_t j = 0; j < m_Targets; j++)
+    {
+        if (hits && j % targetStride == 0 && j / targetStride < hits)
+        {
+            const std::string word = Word(j / targetStride * wordStride);
+            DoHash(m_Algorithm, (const uint8_t*)word.data(), word.size(), &digest[0]);
+            Util::ToHex(&digest[0], digestLength, hex);
+            fwrite(hex, 1, digestLength * 2, expected);
+            fprintf(expected, ":%s\n", word.c_str());
+        }
+        else
+        {
+            uint64_t state = (m_Seed ^ TARGET_STREAM) * 0x9e3779b97f4a7c15ull ^ j;
+            for (size_t b = 0; b < digestLength; b += sizeof(uint64_t))
+            {
+                const uint64_t value = SplitMix(state);
+                memcpy(&digest[b], &value, std::min(sizeof(uint64_t), digestLength - b));
+            }
+            Util::ToHex(&digest[0], digestLength, hex);
+        }
+        fwrite(hex, 1, digestLength * 2 + 1, targets);
+    }
+
+    const bool failed = ferror(wordlist) || ferror(targets) || ferror(expected);
+    fclose(wordlist);
+    fclose(targets);
+    fclose(expected);
+
+    if (failed)
+    {
+        std::cerr << "Error: failed writing to " << m_Output << std::endl;
+        return false;
+    }
+
+    std::cerr << "Wrote " << m_Output / "targets.txt" << ", " << m_Output / "words.txt";
+    std::cerr << " and " << m_Output / "expected.txt" << std::endl;
+    return true;
+}
@@ -0,0 +1,47 @@
+//
+//  DatasetGenerator.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef DatasetGenerator_hpp
+#define DatasetGenerator_hpp
+
+#include <filesystem>
+#include <string>
+
+#include "simdhash.h"
+
+//
+// Writes a reproducible hash list, wordlist and the exact set of
+// cracks expected from running one against the other. Every word
+// and target is derived from the seed and its index alone, so any
+// scale is generated in constant memory and the same seed always
+// gives the same files.
+//
+class DatasetGenerator
+{
+public:
+    DatasetGenerator(void) = default;
+    void SetOutput(const std::filesystem::path Output) { m_Output = Output; }
+    void SetAlgorithm(const HashAlgorithm Algorithm) { m_Algorithm = Algorithm; }
+    void SetSeed(const uint64_t Seed) { m_Seed = Seed; }
+    void SetTargets(const size_t Targets) { m_Targets = Targets; }
+    void SetWords(const size_t Words) { m_Words = Words; }
+    void SetHits(const size_t Hits) { m_Hits = Hits; }
+    const bool Generate(void);
+private:
+    const std::string Word(const size_t Index) const;
+    std::filesystem::path m_Output;
+    HashAlgorithm m_Algorithm = HashAlgorithmSHA1;
+    uint64_t m_Seed = 1;
+    size_t m_Targets = 1000;
+    // Zero means the same as m_Targets
+    size_t m_Words = 0;
+    // Zero means half of the smaller of targets and words
+    size_t m_Hits = 0;
+};
+
+#endif //DatasetGenerator_hpp
@@ -0,0 +1,189 @@
+//
+//  EliasFano.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <string.h>
+
+#include "EliasFano.hpp"
+
+static inline const size_t
+SelectInWord(
+    uint64_t Word,
+    size_t Rank
+)
+{
+    // Clear the lowest set bits until we reach the one we want
+    while (Rank--)
+    {
+        Word &= Word - 1;
+    }
+    return __builtin_ctzll(Word);
+}
+
+const uint64_t
+EliasFano::Key(
+    const uint8_t* const Value
+)
+{
+    uint64_t v64;
+    memcpy(&v64, Value, sizeof(v64));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v64 = __builtin_bswap64(v64);
+#endif
+    return v64;
+}
+
+void
+EliasFano::Build(
+    const uint8_t* const Base,
+    const size_t Count,
+    const size_t Stride
+)
+{
+    m_Count = Count;
+
+    // Pick the low bit width as log2(Universe / Count)
+    const size_t logCount = Count <= 1 ? 0 : 64 - __builtin_clzll(Count - 1);
+    m_LowBits = std::min<size_t>(64 - logCount, 63);
+    m_LowMask = m_LowBits == 0 ? 0 : (1ull << m_LowBits) - 1;
+
+    // The upper bitvector holds one set bit per value plus
+    // one zero for every possible high bucket
+    const size_t buckets = (UINT64_MAX >> m_LowBits) + 1;
+    const size_t upperBits = Count + buckets;
+    m_Upper.assign(upperBits / 64 + 1, 0);
+    // Pad the lower array so reads can always span two words
+    m_Lower.assign((Count * m_LowBits) / 64 + 2, 0);
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        const uint64_t key = Key(Base + i * Stride);
+        const uint64_t position = (key >> m_LowBits) + i;
+        m_Upper[position / 64] |= 1ull << (position % 64);
+
+        if (m_LowBits != 0)
+        {
+            const uint64_t low = key & m_LowMask;
+            const size_t bit = i * m_LowBits;
+            const size_t shift = bit % 64;
+            m_Lower[bit / 64] |= low << shift;
+            if (shift + m_LowBits > 64)
+            {
+                m_Lower[bit / 64 + 1] |= low >> (64 - shift);
+            }
+        }
+    }
+
+    // Sample the position of every SELECT_SAMPLE_RATE'th zero
+    m_ZeroSamples.clear();
+    m_ZeroSamples.reserve(buckets / SELECT_SAMPLE_RATE + 1);
+    size_t zeros = 0;
+    for (size_t word = 0; word < m_Upper.size(); word++)
+    {
+        const uint64_t inverted = ~m_Upper[word];
+        const size_t count = __builtin_popcountll(inverted);
+        while (m_ZeroSamples.size() * SELECT_SAMPLE_RATE < zeros + count)
+        {
+            const size_t rank = m_ZeroSamples.size() * SELECT_SAMPLE_RATE - zeros;
+            m_ZeroSamples.push_back(word * 64 + SelectInWord(inverted, rank));
+        }
+        zeros += count;
+    }
+}
+
+const uint64_t
+EliasFano::GetLow(
+    const size_t Index
+) const
+{
+    if (m_LowBits == 0)
+    {
+        return 0;
+    }
+
+    const size_t bit = Index * m_LowBits;
+    const size_t shift = bit % 64;
+    uint64_t value = m_Lower[bit / 64] >> shift;
+    if (shift + m_LowBits > 64)
+    {
+        value |= m_Lower[bit / 64 + 1] << (64 - shift);
+    }
+    return value & m_LowMask;
+}
+
+const size_t
+EliasFano::Select0(
+    const size_t Rank
+) const
+{
+    // Jump to the nearest sample and scan forward a word at a time
+    const size_t sample = m_ZeroSamples[Rank / SELECT_SAMPLE_RATE];
+    size_t remaining = Rank % SELECT_SAMPLE_RATE;
+    size_t word = sample / 64;
+    uint64_t inverted = ~m_Upper[word] & (UINT64_MAX << (sample % 64));
+
+    while (true)
+    {
+        const size_t count = __builtin_popcountll(inverted);
+        if (remaining < count)
+        {
+            return word * 64 + SelectInWord(inverted, remaining);
+        }
+        remaining -= count;
+        inverted = ~m_Upper[++word];
+    }
+}
+
+const bool
+EliasFano::Find(
+    const uint64_t Value,
+    size_t& Index
+) const
+{
+    if (m_Count == 0)
+    {
+        return false;
+    }
+
+    const uint64_t high = Value >> m_LowBits;
+    const uint64_t low = Value & m_LowMask;
+
+    // Values in bucket 'high' start immediately after the
+    // (high - 1)'th zero in the upper bitvector
+    size_t position = high == 0 ? 0 : Select0(high - 1) + 1;
+    size_t index = position - high;
+
+    // Walk the run of set bits for this bucket. The low
+    // parts are sorted so we can stop as soon as we pass it
+    while (m_Upper[position / 64] & (1ull << (position % 64)))
+    {
+        const uint64_t candidate = GetLow(index);
+        if (candidate == low)
+        {
+            Index = index;
+            return true;
+        }
+        else if (candidate > low)
+        {
+            break;
+        }
+        position++;
+        index++;
+    }
+
+    return false;
+}
+
+const size_t
+EliasFano::GetSizeBytes(
+    void
+) const
+{
+    return (m_Upper.size() + m_Lower.size() + m_ZeroSamples.size()) * sizeof(uint64_t);
+}
@@ -0,0 +1,47 @@
+//
+//  EliasFano.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef EliasFano_hpp
+#define EliasFano_hpp
+
+#include <cstdint>
+#include <vector>
+
+// Number of zeros in the upper bitvector between
+// each sampled position in the select index
+#define SELECT_SAMPLE_RATE (256)
+
+//
+// Succinct encoding of a non-decreasing sequence of 64-bit
+// values. Each value is split into a unary coded high part
+// and a fixed width low part. Lookups use a sampled select
+// index over the high bits so that they run directly on the
+// compressed form.
+//
+class EliasFano
+{
+public:
+    EliasFano(void) = default;
+    void Build(const uint8_t* const Base, const size_t Count, const size_t Stride);
+    const bool Find(const uint64_t Value, size_t& Index) const;
+    const size_t GetCount(void) const { return m_Count; };
+    const size_t GetLowBits(void) const { return m_LowBits; };
+    const size_t GetSizeBytes(void) const;
+    static const uint64_t Key(const uint8_t* const Value);
+private:
+    const uint64_t GetLow(const size_t Index) const;
+    const size_t Select0(const size_t Rank) const;
+    size_t m_Count = 0;
+    size_t m_LowBits = 0;
+    uint64_t m_LowMask = 0;
+    std::vector<uint64_t> m_Upper;
+    std::vector<uint64_t> m_Lower;
+    std::vector<uint64_t> m_ZeroSamples;
+};
+
+#endif //EliasFano_hpp
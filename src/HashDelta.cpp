@@ -0,0 +1,168 @@
+//
+//  HashDelta.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+
+#include "HashDelta.hpp"
+#include "HashList.hpp"
+
+HashDelta::HashDelta(
+    const size_t DigestLength
+) : m_DigestLength(DigestLength), m_Chunks(new std::atomic<DeltaChunk*>[DELTA_MAX_CHUNKS]())
+{
+    m_Snapshot.store(std::make_shared<const DeltaSnapshot>(DeltaSnapshot{{}, 0}));
+}
+
+HashDelta::~HashDelta(
+    void
+)
+{
+    for (size_t i = 0; i < DELTA_MAX_CHUNKS; i++)
+    {
+        delete m_Chunks[i].load();
+    }
+}
+
+const size_t
+HashDelta::Lookup(
+    const DeltaSnapshot& Snapshot,
+    const uint8_t* Hash
+) const
+{
+    if (!m_Filter.Test(Prefix(Hash)))
+    {
+        return HASH_NOT_FOUND;
+    }
+
+    for (auto& run : Snapshot.Runs)
+    {
+        // First slot whose digest is not less than the hash
+        size_t low = 0;
+        size_t high = run->size();
+        while (low < high)
+        {
+            const size_t mid = low + (high - low) / 2;
+            if (memcmp(Digest((*run)[mid]), Hash, m_DigestLength) < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        if (low < run->size() && memcmp(Digest((*run)[low]), Hash, m_DigestLength) == 0)
+        {
+            return (*run)[low];
+        }
+    }
+    return HASH_NOT_FOUND;
+}
+
+const size_t
+HashDelta::Add(
+    const uint8_t* Digests,
+    const size_t Count
+)
+{
+    if (Count == 0)
+    {
+        return 0;
+    }
+
+    // Slots are handed out in digest order so the new run is
+    // sorted as it is built
+    std::vector<uint8_t> batch(Digests, Digests + Count * m_DigestLength);
+    HashList::Sort(&batch[0], Count, m_DigestLength);
+
+    auto current = Acquire();
+    auto run = std::make_shared<std::vector<uint32_t>>();
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        const uint8_t* const digest = &batch[i * m_DigestLength];
+        if ((i != 0 && memcmp(digest - m_DigestLength, digest, m_DigestLength) == 0) ||
+            Lookup(*current, digest) != HASH_NOT_FOUND)
+        {
+            continue;
+        }
+
+        if (m_Count >= DELTA_CHUNK_SIZE * DELTA_MAX_CHUNKS)
+        {
+            std::cerr << "Warning: hash delta is full, ignoring new targets" << std::endl;
+            break;
+        }
+
+        const size_t chunk = m_Count >> DELTA_CHUNK_BITS;
+        if (m_Chunks[chunk].load(std::memory_order_relaxed) == nullptr)
+        {
+            m_Chunks[chunk].store(new DeltaChunk(m_DigestLength), std::memory_order_relaxed);
+        }
+        memcpy(&Chunk(m_Count).Digests[(m_Count % DELTA_CHUNK_SIZE) * m_DigestLength], digest, m_DigestLength);
+        m_Filter.Set(Prefix(digest));
+        run->push_back(m_Count++);
+    }
+
+    const size_t added = run->size();
+    if (added != 0)
+    {
+        auto next = std::make_shared<DeltaSnapshot>(*current);
+        next->Runs.push_back(std::move(run));
+        next->Count += added;
+        // Publishing releases the digests written above
+        m_Snapshot.store(std::move(next), std::memory_order_release);
+    }
+
+    return added;
+}
+
+void
+HashDelta::Compact(
+    void
+)
+{
+    auto current = Acquire();
+    if (current->Runs.size() <= DELTA_MAX_RUNS)
+    {
+        return;
+    }
+
+    auto compare = [this](const uint32_t Left, const uint32_t Right) {
+        return memcmp(Digest(Left), Digest(Right), m_DigestLength) < 0;
+    };
+
+    auto merged = std::make_shared<std::vector<uint32_t>>();
+    merged->reserve(current->Count);
+    for (auto& run : current->Runs)
+    {
+        const size_t middle = merged->size();
+        merged->insert(merged->end(), run->begin(), run->end());
+        std::inplace_merge(merged->begin(), merged->begin() + middle, merged->end(), compare);
+    }
+
+    m_Snapshot.store(std::make_shared<const DeltaSnapshot>(DeltaSnapshot{{merged}, current->Count}), std::memory_order_release);
+}
+
+const size_t
+HashDelta::ExportUncracked(
+    FILE* Output,
+    const bool Binary
+) const
+{
+    size_t written = 0;
+    for (size_t first = 0; first < m_Count; first += DELTA_CHUNK_SIZE)
+    {
+        const DeltaChunk& chunk = Chunk(first);
+        const size_t count = std::min<size_t>(m_Count - first, DELTA_CHUNK_SIZE);
+        written += HashList::WriteUncracked(&chunk.Digests[0], count, m_DigestLength, chunk.Cracked, 0, Binary, Output);
+    }
+    return written;
+}
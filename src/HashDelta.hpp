@@ -0,0 +1,81 @@
+//
+//  HashDelta.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef HashDelta_hpp
+#define HashDelta_hpp
+
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+
+#include "AtomicBitmap.hpp"
+
+// Digests are stored in fixed chunks so that their addresses
+// and cracked bits never move once added
+#define DELTA_CHUNK_BITS (16)
+#define DELTA_CHUNK_SIZE (1ull << DELTA_CHUNK_BITS)
+#define DELTA_MAX_CHUNKS (16384)
+// Runs are merged into one once there are more than this
+#define DELTA_MAX_RUNS (8)
+// Leading digest bits of the filter checked before searching the runs
+#define DELTA_FILTER_BITS (24)
+
+// Sorted runs of slot numbers, immutable once published
+typedef struct _DeltaSnapshot
+{
+    std::vector<std::shared_ptr<const std::vector<uint32_t>>> Runs;
+    size_t Count;
+} DeltaSnapshot;
+
+//
+// Targets added after the main HashList was loaded. Each batch
+// becomes a sorted run and readers search every run of the snapshot
+// they acquired. Runs are merged in the background so lookups stay
+// cheap, while the slot of a target, and so its cracked bit, stays
+// the same for the life of the delta.
+//
+// Add and Compact are for a single writer thread. Readers take a
+// snapshot once per block with Acquire. Almost every lookup is for a
+// digest that is not in the delta, so a bitmap of digest prefixes
+// turns those away before any run is searched.
+//
+class HashDelta
+{
+public:
+    HashDelta(const size_t DigestLength);
+    ~HashDelta(void);
+    // Adds the digests not already in the delta, returns how many
+    const size_t Add(const uint8_t* Digests, const size_t Count);
+    // Merges every run into one if there are more than DELTA_MAX_RUNS
+    void Compact(void);
+    std::shared_ptr<const DeltaSnapshot> Acquire(void) const { return m_Snapshot.load(std::memory_order_acquire); }
+    // Returns the slot of the hash or HASH_NOT_FOUND
+    const size_t Lookup(const DeltaSnapshot& Snapshot, const uint8_t* Hash) const;
+    const bool MarkCracked(const size_t Slot) { return Chunk(Slot).Cracked.Set(Slot % DELTA_CHUNK_SIZE); }
+    const size_t GetCount(void) const { return m_Count; }
+    // Writes every target not yet cracked, returns how many
+    const size_t ExportUncracked(FILE* Output, const bool Binary) const;
+private:
+    typedef struct _DeltaChunk
+    {
+        _DeltaChunk(const size_t DigestLength) : Digests(DELTA_CHUNK_SIZE * DigestLength), Cracked(DELTA_CHUNK_SIZE) {};
+        std::vector<uint8_t> Digests;
+        AtomicBitmap Cracked;
+    } DeltaChunk;
+    DeltaChunk& Chunk(const size_t Slot) const { return *m_Chunks[Slot >> DELTA_CHUNK_BITS].load(std::memory_order_relaxed); }
+    const uint8_t* Digest(const size_t Slot) const { return &Chunk(Slot).Digests[(Slot % DELTA_CHUNK_SIZE) * m_DigestLength]; }
+    static const size_t Prefix(const uint8_t* Hash) { return (Hash[0] << 16 | Hash[1] << 8 | Hash[2]) >> (24 - DELTA_FILTER_BITS); }
+    const size_t m_DigestLength;
+    std::unique_ptr<std::atomic<DeltaChunk*>[]> m_Chunks;
+    size_t m_Count = 0;
+    AtomicBitmap m_Filter = AtomicBitmap(1ull << DELTA_FILTER_BITS);
+    std::atomic<std::shared_ptr<const DeltaSnapshot>> m_Snapshot;
+};
+
+#endif //HashDelta_hpp
@@ -7,35 +7,64 @@
 //
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <iostream>
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/file.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 
+#include "CpuFeatures.hpp"
 #include "HashList.hpp"
+#include "Util.hpp"
 
-// The threshold at which we perform an index
-// of all of the hashes and perform fast lookup
-#define FAST_LOOKUP_THRESHOLD (65536 * 4)
 // The threshold below which we just perform linear
 // lookups and not bother with binary search
 #define LINEAR_LOOKUP_THRESHOLD (512)
 
-static const uint32_t
+// Size of the buffer used when exporting hashes
+#define EXPORT_BUFFER_SIZE (4 * 1024 * 1024)
+
+// Alignment of each region in a shared segment. Large enough
+// for 2MB huge pages when the segment lives on hugetlbfs
+#define SHARED_ALIGNMENT (2 * 1024 * 1024)
+// How long to wait for another process to finish publishing
+#define SHARED_ATTACH_TIMEOUT_MS (10 * 60 * 1000)
+// How long an incomplete segment may go unlocked before its
+// publisher is taken to have died
+#define SHARED_STALE_MS (1000)
+
+// Huge page size used for explicit and transparent huge pages
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Default bucket count targets roughly 2^BUCKET_DEPTH_BITS
+// hashes per bucket, bounded to keep small lists small
+#define BUCKET_DEPTH_BITS (3)
+#define MIN_BITMASK_SIZE (16)
+#define MAX_BITMASK_SIZE (40)
+
+static inline const uint64_t
 Bitmask(
     const uint8_t* const Value,
     const size_t Size
 )
 {
-    uint32_t v32 = *(uint32_t*)Value;
+    uint64_t v64 = *(uint64_t*)Value;
 #ifndef __ARM__
-    v32 = __bswap_32(v32);
+    v64 = __bswap_64(v64);
 #endif
-    v32 >>= (32 - Size);
-    return v32;
+    v64 >>= (64 - Size);
+    return v64;
 }
 
-const bool
+const size_t
 HashList::Lookup(
     const uint8_t* const Base,
     const size_t Size,
@@ -44,36 +73,33 @@ HashList::Lookup(
 )
 {
     assert(Size % HashSize == 0);
-    // Perform the search
-    const uint8_t* base = Base;
-    const uint8_t* top = Base + Size;
-
-    uint8_t* low = (uint8_t*)base;
-    uint8_t* high = (uint8_t*)top - HashSize;
-    uint8_t* mid;
+    // Search for the first entry not less than the hash
+    // so that duplicates always resolve to the same index
+    size_t low = 0;
+    size_t high = Size / HashSize;
 
-    while (low <= high)
+    while (low < high)
     {
-        mid = low + ((high - low) / (2 * HashSize)) * HashSize;
-        int cmp = memcmp(mid, Hash, HashSize);
-        if (cmp == 0)
-        {
-            return true;
-        }
-        else if (cmp < 0)
+        const size_t mid = low + (high - low) / 2;
+        if (memcmp(Base + mid * HashSize, Hash, HashSize) < 0)
         {
-            low = mid + HashSize;
+            low = mid + 1;
         }
         else
         {
-            high = mid - HashSize;
+            high = mid;
         }
     }
 
-    return false;
+    if (low < Size / HashSize && memcmp(Base + low * HashSize, Hash, HashSize) == 0)
+    {
+        return low;
+    }
+
+    return HASH_NOT_FOUND;
 }
 
-const bool
+const size_t
 HashList::LookupLinear(
     const uint8_t* const Base,
     const size_t Size,
@@ -85,10 +111,162 @@ HashList::LookupLinear(
     {
         if (memcmp(offset, Hash, HashSize) == 0)
         {
-            return true;
+            return (offset - Base) / HashSize;
+        }
+    }
+    return HASH_NOT_FOUND;
+}
+
+static MULTIVERSION const size_t
+CountUniqueKernel(
+    const uint8_t* const Base,
+    const size_t Count,
+    const size_t DigestLength,
+    const uint8_t* const Previous
+)
+{
+    size_t unique = 0;
+    const uint8_t* last = Previous;
+    for (const uint8_t* entry = Base; entry < Base + Count * DigestLength; entry += DigestLength)
+    {
+        if (last == nullptr || memcmp(last, entry, DigestLength) != 0)
+        {
+            unique++;
+        }
+        last = entry;
+    }
+    return unique;
+}
+
+const size_t
+HashList::CountUnique(
+    const uint8_t* const Base,
+    const size_t Count,
+    const size_t DigestLength,
+    const uint8_t* const Previous
+)
+{
+    return CountUniqueKernel(Base, Count, DigestLength, Previous);
+}
+
+const bool
+HashList::IsBinaryPath(
+    const std::filesystem::path Path
+)
+{
+    const std::string name = Path.string();
+    return name.ends_with(".bin") || name.ends_with(".dat");
+}
+
+const size_t
+HashList::WriteUncracked(
+    const uint8_t* const Base,
+    const size_t Count,
+    const size_t DigestLength,
+    const AtomicBitmap& Cracked,
+    const size_t First,
+    const bool Binary,
+    FILE* Output,
+    const uint8_t* const Previous
+)
+{
+    const size_t width = Binary ? DigestLength : DigestLength * 2 + 1;
+    std::vector<char> buffer(std::max<size_t>(EXPORT_BUFFER_SIZE / width, 1) * width);
+    char* out = &buffer[0];
+    char* const end = &buffer[0] + buffer.size();
+
+    size_t written = 0;
+    const uint8_t* last = Previous;
+    for (size_t i = 0; i < Count; i++)
+    {
+        const uint8_t* const entry = Base + i * DigestLength;
+        // Duplicates share the cracked state of their first entry
+        // and should only be written out once
+        const bool duplicate = last != nullptr && memcmp(last, entry, DigestLength) == 0;
+        last = entry;
+        if (duplicate || Cracked.Test(First + i))
+        {
+            continue;
+        }
+
+        if (Binary)
+        {
+            memcpy(out, entry, DigestLength);
+        }
+        else
+        {
+            Util::ToHex(entry, DigestLength, out);
+            out[DigestLength * 2] = '\n';
         }
+        out += width;
+        written++;
+
+        if (out == end)
+        {
+            fwrite(&buffer[0], 1, out - &buffer[0], Output);
+            out = &buffer[0];
+        }
+    }
+
+    fwrite(&buffer[0], 1, out - &buffer[0], Output);
+
+    return written;
+}
+
+const bool
+HashList::ExportUncracked(
+    const std::filesystem::path Path
+) const
+{
+    FILE* handle = fopen(Path.c_str(), "wb");
+    if (handle == nullptr)
+    {
+        std::cerr << "Error: unable to open " << Path << " for writing" << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::system_clock::now();
+
+    madvise(m_Base, m_Size, MADV_SEQUENTIAL|MADV_WILLNEED);
+    const size_t written = WriteUncracked(m_Base, m_Count, m_DigestLength, *m_Cracked, 0, IsBinaryPath(Path), handle);
+    madvise(m_Base, m_Size, MADV_RANDOM);
+
+    if (fclose(handle) != 0)
+    {
+        std::cerr << "Error: failed writing " << Path << std::endl;
+        return false;
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+    std::cerr << "Wrote " << written << " uncracked hashes to " << Path << " in " << elapsed_ms.count() << "ms" << std::endl;
+
+    return true;
+}
+
+HashList::~HashList(
+    void
+)
+{
+    // The indexer reads the list so it has to stop first
+    if (m_Indexer.joinable())
+    {
+        m_Indexer.request_stop();
+        m_Indexer.join();
+    }
+
+    if (m_Segment != nullptr)
+    {
+        munmap(m_Segment, m_SegmentSize);
+    }
+    ReleaseHugeRegion();
+    if (!m_Path.empty() && m_Base != nullptr && m_Base != MAP_FAILED)
+    {
+        munmap(m_Base, m_Size);
+    }
+    if (m_BinaryHashFileHandle != nullptr)
+    {
+        fclose(m_BinaryHashFileHandle);
     }
-    return false;
 }
 
 const bool
@@ -102,7 +280,8 @@ HashList::Initialize(
     m_DigestLength = DigestLength;
 
     // Get the file size
-    m_Size = std::filesystem::file_size(m_Path);
+    const size_t fileSize = std::filesystem::file_size(m_Path);
+    m_Size = std::min(fileSize, m_MaxSize);
     m_Count = m_Size / m_DigestLength;
 
     m_BinaryHashFileHandle = fopen(m_Path.c_str(), "r");
@@ -118,9 +297,18 @@ HashList::Initialize(
         return false;
     }
 
-    // Mmap the file
-    m_Base = (uint8_t*)mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, fileno(m_BinaryHashFileHandle), 0);
-    if (m_Base == nullptr)
+    // Mmap the file. If we need to sort it then use a private
+    // writable mapping so that the file itself is left untouched
+    if (Sort)
+    {
+        m_Base = (uint8_t*)mmap(nullptr, m_Size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(m_BinaryHashFileHandle), 0);
+    }
+    else
+    {
+        m_Base = (uint8_t*)mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, fileno(m_BinaryHashFileHandle), 0);
+    }
+
+    if (m_Base == MAP_FAILED)
     {
         std::cerr << "Error: Unable to map hashes file" << std::endl;
         return false;
@@ -130,8 +318,27 @@ HashList::Initialize(
     {
         this->Sort();
     }
+    else if (m_Size == fileSize)
+    {
+        // Only a list that is already sorted on disk
+        // can match an index prebuilt alongside it
+        m_IndexPath = IndexPath(m_Path);
+    }
 
-    return InitializeInternal();
+    if (!InitializeInternal())
+    {
+        return false;
+    }
+
+    // Building the compressed form read the whole list, so drop it
+    // again and let only the pages holding hits come back. A private
+    // sorted copy would be lost so it is left alone
+    if (m_Compressed && !Sort)
+    {
+        madvise(m_Base, m_Size, MADV_DONTNEED);
+    }
+
+    return true;
 }
 
 const bool
@@ -156,210 +363,979 @@ HashList::Initialize(
 }
 
 const bool
-HashList::InitializeInternal(
+HashList::InitializeCompressed(
     void
 )
 {
-    auto ret = madvise(m_Base, m_Size, MADV_RANDOM|MADV_WILLNEED);
+    // Only the matched entries are ever read from the backing
+    // store so we don't want it all paged in up front
+    auto ret = madvise(m_Base, m_Size, MADV_RANDOM);
     if (ret != 0)
     {
         std::cerr << "Madvise not happy" << std::endl;
     }
 
-    // Build lookup table
-    std::cerr << "Indexing hash table." << std::flush;
+    std::cerr << "Compressing hash table." << std::flush;
+
+    m_Succinct.Build(m_Base, m_Count, m_DigestLength);
+
+    const size_t bytes = m_Succinct.GetSizeBytes();
+    std::cerr << "\rCompressed " << m_Count << " hashes into " << bytes << " bytes (";
+    std::cerr << (m_Count ? (double)(bytes * 8) / m_Count : 0) << " bits per hash)" << std::endl;
+
+    return true;
+}
 
-    m_LookupTable.resize(1 << m_BitmaskSize);
-    for (auto &entry : m_LookupTable)
+const bool
+HashList::InitializeInternal(
+    void
+)
+{
+    if (!InitializeTables())
     {
-        entry.Offset = INVALID_OFFSET;
-        entry.Count = 0;
+        return false;
     }
 
-    constexpr size_t READAHEAD = 512;
+    // A lazily built index publishes itself once it is ready
+    if (!m_Indexer.joinable())
+    {
+        m_Offsets = m_LookupTable.empty() ? nullptr : &m_LookupTable[0];
+    }
 
-    // For lists larger than FAST_LOOKUP_THRESHOLD
-    // We need to index the offset list
-    if (m_Count >= FAST_LOOKUP_THRESHOLD)
+    if (m_HugePages && !m_Compressed)
     {
-        // First pass
-        std::cerr << "\rIndexing hash table. Pass 1" << std::flush;
-        for (size_t i = 0; i < m_Count; i+= READAHEAD)
-        {
-            const uint8_t* const pointer = m_Base + (i * m_DigestLength);
-            const uint32_t index = Bitmask(pointer, m_BitmaskSize);
-            if (m_LookupTable[index].Offset == INVALID_OFFSET)
-            {
-                m_LookupTable[index].Offset = i;
-            }
-        }
+        WaitForIndex();
+        MoveToHugePages();
+    }
 
-        // Third pass -> N'th pass
-        // Loop over each known endpoint and check the previous entry
-        size_t pass = 2;
-        bool foundNewEntry;
-        do
-        {
-            foundNewEntry = false;
-            std::cerr << "\rIndexing hash table. Pass " << pass++ << std::flush;
-            for (size_t i = 0; i < m_LookupTable.size(); i++)
-            {
-                if (m_LookupTable[i].Offset == INVALID_OFFSET || m_LookupTable[i].Offset == 0)
-                {
-                    continue;
-                }
-
-                const uint8_t* pointer = m_Base + (m_LookupTable[i].Offset * m_DigestLength);
-
-                // Walk backwards until we find the previous
-                while (pointer > m_Base)
-                {
-                    pointer -= m_DigestLength;
-                    const uint32_t index = Bitmask(pointer, m_BitmaskSize);
-                    if (index == i)
-                    {
-                        m_LookupTable[i].Offset = (pointer - m_Base) / m_DigestLength;
-                    }
-                    else
-                    {
-                        if (m_LookupTable[index].Offset == INVALID_OFFSET)
-                        {
-                            m_LookupTable[index].Offset = (pointer - m_Base) / m_DigestLength;
-                            foundNewEntry = true;
-                        }
-                        break;
-                    }
-                }
-            }
-        } while(foundNewEntry);
+    // Duplicate targets all resolve to their first entry so
+    // completion is measured against the unique count
+    m_UniqueCount = CountUnique(m_Base, m_Count, m_DigestLength);
+    m_Cracked = std::make_shared<AtomicBitmap>(m_Count);
 
-        std::cerr << std::endl;
+    return true;
+}
 
-        // Calculate the counts
-        // We walk through each item, look for the next offset
-        // and calculate the distance between them
-        for (size_t i = 0; i < m_LookupTable.size(); i++)
-        {
-            // Find the next closest offset
-            if (m_LookupTable[i].Offset == INVALID_OFFSET)
-            {
-                continue;
-            }
+static inline const size_t
+AlignHuge(
+    const size_t Value
+)
+{
+    return (Value + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
 
-            for (size_t j = i + 1; j < m_LookupTable.size(); j++)
-            {
-                if (m_LookupTable[j].Offset != INVALID_OFFSET)
-                {
-                    assert(m_LookupTable[j].Offset > m_LookupTable[i].Offset);
-                    m_LookupTable[i].Count = m_LookupTable[j].Offset - m_LookupTable[i].Offset;
-                    break;
-                }
-            }
-        }
+//
+// Allocates Size bytes of huge page memory, preferring reserved
+// hugetlb pages and otherwise asking for transparent huge pages
+//
+static uint8_t*
+AllocateHuge(
+    const size_t Size,
+    bool& Explicit
+)
+{
+    void* region = mmap(nullptr, Size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (region != MAP_FAILED)
+    {
+        Explicit = true;
+        return (uint8_t*)region;
+    }
 
-        // Handle the last entry
-        for (size_t i = m_LookupTable.size() - 1; i > 0; i--)
-        {
-            if (m_LookupTable[i].Offset != INVALID_OFFSET)
-            {
-                const uint8_t* const end = m_Base + m_Size;
-                const uint8_t* const pointer = m_Base + (m_LookupTable[i].Offset * m_DigestLength);
-                m_LookupTable[i].Count = (end - pointer) / m_DigestLength;
-            }
-        }
+    // Over allocate so the region can start on a huge page boundary
+    region = mmap(nullptr, Size + HUGE_PAGE_SIZE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+        return nullptr;
     }
 
-    return true;
+    uint8_t* const aligned = (uint8_t*)AlignHuge((size_t)region);
+    if (aligned != region)
+    {
+        munmap(region, aligned - (uint8_t*)region);
+    }
+    munmap(aligned + Size, (uint8_t*)region + HUGE_PAGE_SIZE - aligned);
+
+    if (madvise(aligned, Size, MADV_HUGEPAGE) != 0)
+    {
+        std::cerr << "Warning: transparent huge pages unavailable" << std::endl;
+    }
+
+    Explicit = false;
+    return aligned;
 }
 
-const bool
-HashList::LookupLinear(
-    const uint8_t* Hash
-) const
+//
+// Copies with one thread per core so that the page faults
+// are taken in parallel
+//
+static void
+ParallelCopy(
+    uint8_t* Destination,
+    const uint8_t* Source,
+    const size_t Size
+)
 {
-    for (uint8_t* offset = m_Base; offset < m_Base + m_Size; offset += m_DigestLength)
+    const size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t slice = AlignHuge((Size + threads - 1) / threads);
+    std::vector<std::thread> copiers;
+    for (size_t offset = 0; offset < Size; offset += slice)
     {
-        if (memcmp(offset, Hash, m_DigestLength) == 0)
-        {
-            return true;
-        }
+        copiers.emplace_back(memcpy, Destination + offset, Source + offset, std::min(slice, Size - offset));
+    }
+    for (auto& copier : copiers)
+    {
+        copier.join();
+    }
+}
+
+void
+HashList::ReleaseHugeRegion(
+    void
+)
+{
+    if (m_HugeRegion != nullptr)
+    {
+        munmap(m_HugeRegion, m_HugeSize);
+        m_HugeRegion = nullptr;
+        m_HugeSize = 0;
     }
-    return false;
 }
 
 const bool
-HashList::LookupFast(
-    const uint8_t* Hash
-) const
+HashList::MoveToHugePages(
+    void
+)
 {
-    const uint32_t index = Bitmask(Hash, m_BitmaskSize);
-    const LookupTable& entry = m_LookupTable[index];
+    auto start = std::chrono::system_clock::now();
 
-    if (entry.Count == 0)
+    const size_t hashBytes = AlignHuge(m_Size);
+    const size_t tableBytes = m_LookupTable.size() * sizeof(uint64_t);
+    bool explicitPages;
+    const size_t regionBytes = hashBytes + AlignHuge(tableBytes);
+    uint8_t* region = AllocateHuge(regionBytes, explicitPages);
+    if (region == nullptr)
     {
+        std::cerr << "Warning: unable to allocate huge pages, using the file mapping" << std::endl;
         return false;
     }
 
-    return Lookup(
-        m_Base + entry.Offset * m_DigestLength,
-        entry.Count * m_DigestLength,
-        Hash,
-        m_DigestLength
-    );
-}
+    ParallelCopy(region, m_Base, m_Size);
+    if (tableBytes != 0)
+    {
+        ParallelCopy(region + hashBytes, (const uint8_t*)&m_LookupTable[0], tableBytes);
+        m_Offsets = (const uint64_t*)(region + hashBytes);
+        m_LookupTable = std::vector<uint64_t>();
+    }
 
-const bool
-HashList::LookupBinary(
-    const uint8_t* Hash
-) const
-{
-    return Lookup(
-        m_Base,
-        m_Size,
-        Hash,
-        m_DigestLength
-    );
+    if (!m_Path.empty())
+    {
+        munmap(m_Base, m_Size);
+        m_Path.clear();
+    }
+    m_Base = region;
+    m_HugeRegion = region;
+    m_HugeSize = regionBytes;
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+    std::cerr << "Loaded " << (hashBytes + tableBytes) / (1024 * 1024) << "MB into " << (explicitPages ? "explicit" : "transparent");
+    std::cerr << " huge pages in " << elapsed_ms.count() << "ms" << std::endl;
+
+    return true;
 }
 
 const bool
-HashList::Lookup(
-    const uint8_t* Hash
-) const
+HashList::InitializeTables(
+    void
+)
 {
-    if (m_Count >= FAST_LOOKUP_THRESHOLD)
+    if (m_Compressed)
     {
-        return LookupFast(Hash);
+        return InitializeCompressed();
     }
-    else if (m_Count <= LINEAR_LOOKUP_THRESHOLD)
+
+    auto ret = madvise(m_Base, m_Size, MADV_RANDOM|MADV_WILLNEED);
+    if (ret != 0)
     {
-        return LookupLinear(Hash);
+        std::cerr << "Madvise not happy" << std::endl;
     }
-    else
+
+    // For lists larger than FAST_LOOKUP_THRESHOLD
+    // We need to index the offset list
+    if (m_Count < FAST_LOOKUP_THRESHOLD)
     {
-        return LookupBinary(Hash);
+        return true;
+    }
+
+    // Scale the number of buckets with the size of the list
+    if (m_BitmaskSize == 0)
+    {
+        const size_t log2Count = 63 - __builtin_clzll(m_Count);
+        m_BitmaskSize = std::clamp<size_t>(log2Count - BUCKET_DEPTH_BITS, MIN_BITMASK_SIZE, MAX_BITMASK_SIZE);
+    }
+
+    if (m_BitmaskSize > MAX_BITMASK_SIZE || m_BitmaskSize > m_DigestLength * 8)
+    {
+        std::cerr << "Error: bitmask size " << m_BitmaskSize << " is too large" << std::endl;
+        return false;
+    }
+
+    // Use the prebuilt index if there is one
+    if (!m_IndexPath.empty() && std::filesystem::exists(m_IndexPath) && LoadIndex(m_IndexPath))
+    {
+        std::cerr << "Loaded index " << m_IndexPath << " (" << m_BitmaskSize << " bit buckets)" << std::endl;
+        return true;
+    }
+
+    if (m_LazyIndex)
+    {
+        std::cerr << "Indexing hash table in the background (" << m_BitmaskSize << " bit buckets)" << std::endl;
+        m_Indexer = std::jthread([this](std::stop_token Stop) {
+            auto start = std::chrono::system_clock::now();
+            if (!BuildTable(Stop))
+            {
+                return;
+            }
+            __atomic_store_n(&m_Offsets, &m_LookupTable[0], __ATOMIC_RELEASE);
+            auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+            std::cerr << "\rIndex ready after " << elapsed_ms.count() << "ms" << std::endl;
+        });
+        return true;
     }
+
+    // Build lookup table
+    std::cerr << "Indexing hash table (" << m_BitmaskSize << " bit buckets)." << std::flush;
+    BuildTable(std::stop_token());
+    std::cerr << std::endl;
+
+    return true;
 }
 
-#ifdef __APPLE__
-int
-Compare(
-    void* Length,
-    const void* Value1,
-    const void* Value2
+const bool
+HashList::BuildTable(
+    std::stop_token Stop
 )
 {
-    return memcmp(Value1, Value2, (size_t)Length);
-}
+    // One extra entry so that the end of the final bucket
+    // is always the next entry's offset
+    const size_t buckets = 1ull << m_BitmaskSize;
+    m_LookupTable.resize(buckets + 1);
+    m_LookupTable[buckets] = m_Count;
+
+    // Split the buckets between threads. Each thread finds its first
+    // boundary with a binary search and gallops forward from there
+    const size_t threads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, buckets);
+    const size_t perThread = (buckets + threads - 1) / threads;
+    std::vector<std::thread> indexers;
+    for (size_t first = 0; first < buckets; first += perThread)
+    {
+        indexers.emplace_back(
+            &HashList::IndexRange,
+            this,
+            first,
+            std::min(first + perThread, buckets),
+            Stop
+        );
+    }
+
+    for (auto& indexer : indexers)
+    {
+        indexer.join();
+    }
+
+    return !Stop.stop_requested();
+}
+
+void
+HashList::WaitForIndex(
+    void
+)
+{
+    if (m_Indexer.joinable())
+    {
+        m_Indexer.join();
+    }
+}
+
+MULTIVERSION const size_t
+HashList::LowerBound(
+    const uint64_t Bucket,
+    size_t Low,
+    size_t High
+) const
+{
+    while (Low < High)
+    {
+        const size_t mid = Low + (High - Low) / 2;
+        if (Bitmask(m_Base + mid * m_DigestLength, m_BitmaskSize) < Bucket)
+        {
+            Low = mid + 1;
+        }
+        else
+        {
+            High = mid;
+        }
+    }
+    return Low;
+}
+
+void
+HashList::IndexRange(
+    const size_t First,
+    const size_t Last,
+    std::stop_token Stop
+)
+{
+    size_t offset = LowerBound(First, 0, m_Count);
+    m_LookupTable[First] = offset;
+
+    for (size_t bucket = First + 1; bucket < Last; bucket++)
+    {
+        if (bucket % 4096 == 0 && Stop.stop_requested())
+        {
+            return;
+        }
+
+        // Gallop forward from the previous boundary to bracket
+        // the start of this bucket, then binary search within it
+        size_t low = offset;
+        size_t high = offset;
+        size_t step = 1;
+        while (high < m_Count && Bitmask(m_Base + high * m_DigestLength, m_BitmaskSize) < bucket)
+        {
+            low = high + 1;
+            high += step;
+            step <<= 1;
+        }
+        offset = LowerBound(bucket, low, std::min(high, m_Count));
+        m_LookupTable[bucket] = offset;
+    }
+}
+
+MULTIVERSION const size_t
+HashList::LookupLinear(
+    const uint8_t* Hash
+) const
+{
+    return LookupLinear(
+        m_Base,
+        m_Size,
+        Hash,
+        m_DigestLength
+    );
+}
+
+MULTIVERSION const size_t
+HashList::LookupFast(
+    const uint8_t* Hash
+) const
+{
+    const uint64_t* const offsets = __atomic_load_n(&m_Offsets, __ATOMIC_ACQUIRE);
+
+    // Until a lazily built index is ready the whole list is searched
+    if (offsets == nullptr)
+    {
+        return LookupBinary(Hash);
+    }
+
+    const uint64_t index = Bitmask(Hash, m_BitmaskSize);
+    const uint64_t first = offsets[index];
+    const uint64_t last = offsets[index + 1];
+
+    if (first == last)
+    {
+        return HASH_NOT_FOUND;
+    }
+
+    const size_t offset = Lookup(
+        m_Base + first * m_DigestLength,
+        (last - first) * m_DigestLength,
+        Hash,
+        m_DigestLength
+    );
+
+    return offset == HASH_NOT_FOUND ? HASH_NOT_FOUND : first + offset;
+}
+
+MULTIVERSION const size_t
+HashList::LookupBinary(
+    const uint8_t* Hash
+) const
+{
+    return Lookup(
+        m_Base,
+        m_Size,
+        Hash,
+        m_DigestLength
+    );
+}
+
+const size_t
+HashList::LookupCompressed(
+    const uint8_t* Hash
+) const
+{
+    const uint64_t key = EliasFano::Key(Hash);
+    size_t index;
+
+    if (!m_Succinct.Find(key, index))
+    {
+        return HASH_NOT_FOUND;
+    }
+
+    // The compressed form only holds the leading 64 bits of each
+    // digest so confirm the hit against the full sorted list
+    for (; index < m_Count; index++)
+    {
+        const uint8_t* const entry = m_Base + index * m_DigestLength;
+        if (memcmp(entry, Hash, m_DigestLength) == 0)
+        {
+            return index;
+        }
+        if (EliasFano::Key(entry) != key)
+        {
+            break;
+        }
+    }
+
+    return HASH_NOT_FOUND;
+}
+
+const size_t
+HashList::Lookup(
+    const uint8_t* Hash
+) const
+{
+    if (m_Compressed)
+    {
+        return LookupCompressed(Hash);
+    }
+    else if (m_Count >= FAST_LOOKUP_THRESHOLD)
+    {
+        return LookupFast(Hash);
+    }
+    else if (m_Count <= LINEAR_LOOKUP_THRESHOLD)
+    {
+        return LookupLinear(Hash);
+    }
+    else
+    {
+        return LookupBinary(Hash);
+    }
+}
+
+void
+HashList::Replicate(
+    HashList& Replica
+) const
+{
+    Replica.m_DigestLength = m_DigestLength;
+    Replica.m_BinaryHashFileHandle = nullptr;
+    Replica.m_Count = m_Count;
+    Replica.m_Size = m_Size;
+    Replica.m_BitmaskSize = m_BitmaskSize;
+    Replica.m_Compressed = m_Compressed;
+    Replica.m_UniqueCount = m_UniqueCount;
+    Replica.m_Cracked = m_Cracked;
+
+    Replica.m_Replica.assign(m_Base, m_Base + m_Size);
+    Replica.m_Base = Replica.m_Replica.data();
+
+    if (m_Compressed)
+    {
+        Replica.m_Succinct = m_Succinct;
+    }
+    else if (m_Offsets != nullptr)
+    {
+        Replica.m_LookupTable.assign(m_Offsets, m_Offsets + (1ull << m_BitmaskSize) + 1);
+        Replica.m_Offsets = &Replica.m_LookupTable[0];
+    }
+}
+
+#ifdef __APPLE__
+int
+Compare(
+    void* Length,
+    const void* Value1,
+    const void* Value2
+)
+{
+    return memcmp(Value1, Value2, (size_t)Length);
+}
 #endif
 
 void
 HashList::Sort(
-    void
+    uint8_t* Base,
+    const size_t Count,
+    const size_t DigestLength
 )
 {
 #ifdef __APPLE__
-    qsort_r(m_Targets, m_TargetsCount, m_HashWidth, (void*)m_HashWidth, Compare);
+    qsort_r(Base, Count, DigestLength, (void*)DigestLength, Compare);
 #else
-    qsort_r(m_Base, m_Count, m_DigestLength, (__compar_d_fn_t)memcmp, (void*)m_DigestLength);
+    qsort_r(Base, Count, DigestLength, (__compar_d_fn_t)memcmp, (void*)DigestLength);
 #endif
-}
\ No newline at end of file
+}
+
+void
+HashList::Sort(
+    void
+)
+{
+    Sort(m_Base, m_Count, m_DigestLength);
+}
+
+const std::filesystem::path
+HashList::IndexPath(
+    const std::filesystem::path Path
+)
+{
+    return Path.string() + ".idx";
+}
+
+const bool
+HashList::SaveIndex(
+    const std::filesystem::path Path
+) const
+{
+    if (m_Offsets == nullptr)
+    {
+        std::cerr << "Hash list is too small to need an index" << std::endl;
+        return true;
+    }
+
+    FILE* handle = fopen(Path.c_str(), "wb");
+    if (handle == nullptr)
+    {
+        std::cerr << "Error: unable to open index file for writing" << std::endl;
+        return false;
+    }
+
+    IndexHeader header;
+    memcpy(header.Magic, INDEX_MAGIC, sizeof(header.Magic));
+    header.Version = INDEX_VERSION;
+    header.DigestLength = m_DigestLength;
+    header.Count = m_Count;
+    header.BitmaskSize = m_BitmaskSize;
+
+    bool success = fwrite(&header, sizeof(header), 1, handle) == 1;
+    const size_t entries = (1ull << m_BitmaskSize) + 1;
+    success &= fwrite(m_Offsets, sizeof(uint64_t), entries, handle) == entries;
+    success &= fclose(handle) == 0;
+
+    if (!success)
+    {
+        std::cerr << "Error: failed writing index file" << std::endl;
+    }
+
+    return success;
+}
+
+const bool
+HashList::LoadIndex(
+    const std::filesystem::path Path
+)
+{
+    FILE* handle = fopen(Path.c_str(), "rb");
+    if (handle == nullptr)
+    {
+        return false;
+    }
+
+    // The index must describe this exact list, and honour
+    // an explicitly requested bitmask size
+    IndexHeader header;
+    if (fread(&header, sizeof(header), 1, handle) != 1 ||
+        memcmp(header.Magic, INDEX_MAGIC, sizeof(header.Magic)) != 0 ||
+        header.Version != INDEX_VERSION ||
+        header.DigestLength != m_DigestLength ||
+        header.Count != m_Count ||
+        header.BitmaskSize == 0 ||
+        header.BitmaskSize > MAX_BITMASK_SIZE ||
+        (m_BitmaskSize != 0 && m_BitmaskSize != header.BitmaskSize))
+    {
+        std::cerr << "Ignoring stale or mismatched index " << Path << std::endl;
+        fclose(handle);
+        return false;
+    }
+
+    m_LookupTable.resize((1ull << header.BitmaskSize) + 1);
+    const bool success = fread(&m_LookupTable[0], sizeof(uint64_t), m_LookupTable.size(), handle) == m_LookupTable.size();
+    fclose(handle);
+
+    if (!success || m_LookupTable.back() != m_Count)
+    {
+        std::cerr << "Ignoring truncated index " << Path << std::endl;
+        m_LookupTable.clear();
+        return false;
+    }
+
+    m_BitmaskSize = header.BitmaskSize;
+    return true;
+}
+
+static int
+OpenShared(
+    const std::string Name,
+    const int Flags
+)
+{
+    // Anything that looks like a path is opened as a regular file,
+    // for example on a hugetlbfs mount. Otherwise it is a POSIX
+    // shared memory object
+    if (Name.find('/', 1) != std::string::npos)
+    {
+        return open(Name.c_str(), Flags, 0644);
+    }
+    return shm_open(Name.starts_with("/") ? Name.c_str() : ("/" + Name).c_str(), Flags, 0644);
+}
+
+// Size and modification time of the hash file, zero for sources
+// that are not regular files
+static void
+StatSource(
+    const std::string Source,
+    uint64_t& Size,
+    int64_t& Mtime
+)
+{
+    struct stat info;
+    Size = 0;
+    Mtime = 0;
+    if (stat(Source.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+    {
+        Size = info.st_size;
+        Mtime = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+    }
+}
+
+// Removes the segment Fd was opened from, unless another process
+// has already replaced it under the same name
+static void
+RemoveStale(
+    const std::string Name,
+    const int Fd
+)
+{
+    const int fd = OpenShared(Name, O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat ours;
+    struct stat current;
+    if (fstat(Fd, &ours) == 0 && fstat(fd, &current) == 0 &&
+        ours.st_dev == current.st_dev && ours.st_ino == current.st_ino)
+    {
+        HashList::UnlinkShared(Name);
+    }
+    close(fd);
+}
+
+static inline const size_t
+AlignShared(
+    const size_t Value
+)
+{
+    return (Value + SHARED_ALIGNMENT - 1) / SHARED_ALIGNMENT * SHARED_ALIGNMENT;
+}
+
+const bool
+HashList::SharedExists(
+    const std::string Name
+)
+{
+    const int fd = OpenShared(Name, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+const bool
+HashList::UnlinkShared(
+    const std::string Name
+)
+{
+    const int result = Name.find('/', 1) != std::string::npos ?
+        unlink(Name.c_str()) :
+        shm_unlink(Name.starts_with("/") ? Name.c_str() : ("/" + Name).c_str());
+    if (result != 0)
+    {
+        std::cerr << "Error: unable to remove shared segment " << Name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    std::cerr << "Removed shared segment " << Name << std::endl;
+    return true;
+}
+
+const bool
+HashList::Publish(
+    const std::string Name,
+    const std::string Source,
+    const uint32_t Algorithm
+)
+{
+    if (m_Compressed)
+    {
+        std::cerr << "Error: compressed hash lists cannot be shared" << std::endl;
+        return false;
+    }
+
+    WaitForIndex();
+
+    const size_t entries = m_Offsets == nullptr ? 0 : (1ull << m_BitmaskSize) + 1;
+    const size_t hashesOffset = AlignShared(sizeof(SharedHeader));
+    const size_t tableOffset = AlignShared(hashesOffset + m_Size);
+    const size_t totalSize = AlignShared(tableOffset + entries * sizeof(uint64_t));
+
+    int fd = OpenShared(Name, O_CREAT|O_EXCL|O_RDWR);
+    if (fd < 0 && errno == EEXIST)
+    {
+        // Another process started at the same time and won the race
+        // to create the segment, so use theirs instead. Our own copy
+        // is only released once attached
+        uint8_t* const base = m_Path.empty() ? nullptr : m_Base;
+        const size_t size = m_Size;
+        uint32_t algorithm = Algorithm;
+        if (Attach(Name, Source, algorithm))
+        {
+            if (base != nullptr)
+            {
+                munmap(base, size);
+                m_Path.clear();
+            }
+            ReleaseHugeRegion();
+            m_LookupTable = std::vector<uint64_t>();
+            return true;
+        }
+
+        // Attach removes a segment left behind by a publisher that
+        // died, in which case it can be created again
+        if (SharedExists(Name))
+        {
+            std::cerr << "Warning: unable to use shared segment " << Name << ", continuing with a private copy" << std::endl;
+            return true;
+        }
+        fd = OpenShared(Name, O_CREAT|O_EXCL|O_RDWR);
+    }
+
+    if (fd < 0)
+    {
+        std::cerr << "Error: unable to create shared segment " << Name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Held until the segment is complete so that attaching processes
+    // can tell a slow publisher from one that died
+    flock(fd, LOCK_EX);
+
+    if (ftruncate(fd, totalSize) != 0)
+    {
+        std::cerr << "Error: unable to size shared segment " << Name << ": " << strerror(errno) << std::endl;
+        UnlinkShared(Name);
+        close(fd);
+        return false;
+    }
+
+    uint8_t* segment = (uint8_t*)mmap(nullptr, totalSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (segment == MAP_FAILED)
+    {
+        std::cerr << "Error: unable to map shared segment " << Name << std::endl;
+        UnlinkShared(Name);
+        close(fd);
+        return false;
+    }
+
+    std::cerr << "Publishing hash list to " << Name << std::endl;
+
+    SharedHeader* header = (SharedHeader*)segment;
+    header->Version = SHARED_VERSION;
+    header->Algorithm = Algorithm;
+    header->DigestLength = m_DigestLength;
+    header->Count = m_Count;
+    header->UniqueCount = m_UniqueCount;
+    header->BitmaskSize = m_BitmaskSize;
+    header->TableEntries = entries;
+    header->HashesOffset = hashesOffset;
+    header->TableOffset = tableOffset;
+    header->TotalSize = totalSize;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    StatSource(Source, sourceSize, sourceMtime);
+    header->SourceSize = sourceSize;
+    header->SourceMtime = sourceMtime;
+    strncpy(header->Source, Source.c_str(), sizeof(header->Source) - 1);
+
+    memcpy(segment + hashesOffset, m_Base, m_Size);
+    if (entries != 0)
+    {
+        memcpy(segment + tableOffset, m_Offsets, entries * sizeof(uint64_t));
+    }
+
+    // Attaching processes wait for the magic so it goes in last
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->Magic, SHARED_MAGIC, sizeof(header->Magic));
+    munmap(segment, totalSize);
+
+    // Switch over to the shared copy so the memory is only paid once
+    segment = (uint8_t*)mmap(nullptr, totalSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED)
+    {
+        std::cerr << "Error: unable to map shared segment " << Name << std::endl;
+        return false;
+    }
+
+    if (!m_Path.empty())
+    {
+        munmap(m_Base, m_Size);
+        m_Path.clear();
+    }
+    ReleaseHugeRegion();
+
+    m_Segment = segment;
+    m_SegmentSize = totalSize;
+    m_Base = segment + hashesOffset;
+    m_Offsets = entries != 0 ? (const uint64_t*)(segment + tableOffset) : nullptr;
+    m_LookupTable = std::vector<uint64_t>();
+
+    madvise(m_Base, m_Size, MADV_RANDOM);
+
+    return true;
+}
+
+const bool
+HashList::Attach(
+    const std::string Name,
+    const std::string Source,
+    uint32_t& Algorithm
+)
+{
+    const int fd = OpenShared(Name, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Another process may still be publishing the list. It holds a
+    // lock on the segment until the magic is written, so an
+    // incomplete segment nobody has locked was left by a publisher
+    // that died
+    const SharedHeader* header = nullptr;
+    struct stat info;
+    size_t unlocked = 0;
+    for (size_t waited = 0; ; waited += 100)
+    {
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(SharedHeader))
+        {
+            header = (const SharedHeader*)mmap(nullptr, sizeof(SharedHeader), PROT_READ, MAP_SHARED, fd, 0);
+            if (header != MAP_FAILED && memcmp(header->Magic, SHARED_MAGIC, sizeof(header->Magic)) == 0)
+            {
+                break;
+            }
+            if (header != MAP_FAILED)
+            {
+                munmap((void*)header, sizeof(SharedHeader));
+            }
+            header = nullptr;
+        }
+
+        if (flock(fd, LOCK_SH|LOCK_NB) == 0)
+        {
+            flock(fd, LOCK_UN);
+            unlocked += 100;
+        }
+        else
+        {
+            unlocked = 0;
+        }
+
+        // Allow for the moment between creating the segment and locking it
+        if (unlocked > SHARED_STALE_MS)
+        {
+            std::cerr << "Shared segment " << Name << " was left incomplete by a publisher that exited" << std::endl;
+            RemoveStale(Name, fd);
+            close(fd);
+            return false;
+        }
+
+        if (waited == 0)
+        {
+            std::cerr << "Waiting for " << Name << " to be published" << std::endl;
+        }
+        else if (waited >= SHARED_ATTACH_TIMEOUT_MS)
+        {
+            std::cerr << "Error: shared segment " << Name << " was never completed, remove it and retry" << std::endl;
+            close(fd);
+            return false;
+        }
+        usleep(100 * 1000);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    StatSource(Source, sourceSize, sourceMtime);
+
+    if (header->Version != SHARED_VERSION ||
+        header->TotalSize > (size_t)info.st_size ||
+        strncmp(header->Source, Source.c_str(), sizeof(header->Source) - 1) != 0)
+    {
+        std::cerr << "Error: shared segment " << Name << " holds a different hash list (" << header->Source << ")" << std::endl;
+        munmap((void*)header, sizeof(SharedHeader));
+        close(fd);
+        return false;
+    }
+
+    if (Algorithm != HashAlgorithmUndefined && header->Algorithm != Algorithm)
+    {
+        std::cerr << "Error: shared segment " << Name << " holds a different hash algorithm" << std::endl;
+        munmap((void*)header, sizeof(SharedHeader));
+        close(fd);
+        return false;
+    }
+
+    if (header->SourceSize != sourceSize || header->SourceMtime != sourceMtime)
+    {
+        std::cerr << "Error: shared segment " << Name << " holds an older version of " << Source;
+        std::cerr << ", remove it with --shm-unlink " << Name << std::endl;
+        munmap((void*)header, sizeof(SharedHeader));
+        close(fd);
+        return false;
+    }
+
+    const size_t totalSize = header->TotalSize;
+    munmap((void*)header, sizeof(SharedHeader));
+
+    const uint8_t* segment = (const uint8_t*)mmap(nullptr, totalSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED)
+    {
+        std::cerr << "Error: unable to map shared segment " << Name << std::endl;
+        return false;
+    }
+
+    m_Segment = (uint8_t*)segment;
+    m_SegmentSize = totalSize;
+    header = (const SharedHeader*)segment;
+    Algorithm = header->Algorithm;
+    m_DigestLength = header->DigestLength;
+    m_Count = header->Count;
+    m_UniqueCount = header->UniqueCount;
+    m_BitmaskSize = header->BitmaskSize;
+    m_Size = m_Count * m_DigestLength;
+    m_Base = (uint8_t*)segment + header->HashesOffset;
+    m_Offsets = header->TableEntries != 0 ? (const uint64_t*)(segment + header->TableOffset) : nullptr;
+    m_Cracked = std::make_shared<AtomicBitmap>(m_Count);
+
+    madvise(m_Base, m_Size, MADV_RANDOM);
+
+    std::cerr << "Attached to shared hash list " << Name << " (" << m_Count << " hashes)" << std::endl;
+
+    return true;
+}
@@ -10,44 +10,152 @@
 #define HashList_hpp
 
 #include <filesystem>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <stdio.h>
 
-typedef struct __attribute__((packed)) _LookupTable
+#include "AtomicBitmap.hpp"
+#include "CpuFeatures.hpp"
+#include "EliasFano.hpp"
+
+typedef struct __attribute__((packed)) _IndexHeader
+{
+    char Magic[4];
+    uint32_t Version;
+    uint64_t DigestLength;
+    uint64_t Count;
+    uint64_t BitmaskSize;
+} IndexHeader;
+
+#define INDEX_MAGIC "CLIX"
+#define INDEX_VERSION (1)
+
+typedef struct __attribute__((packed)) _SharedHeader
 {
-    uint32_t Offset;
-    uint32_t Count;
-} LookupTable;
+    char Magic[4];
+    uint32_t Version;
+    uint32_t Algorithm;
+    uint32_t Reserved;
+    uint64_t DigestLength;
+    uint64_t Count;
+    uint64_t UniqueCount;
+    uint64_t BitmaskSize;
+    uint64_t TableEntries;
+    uint64_t HashesOffset;
+    uint64_t TableOffset;
+    uint64_t TotalSize;
+    // Size and modification time (ns) of the hash file when published
+    uint64_t SourceSize;
+    int64_t SourceMtime;
+    char Source[256];
+} SharedHeader;
+
+#define SHARED_MAGIC "CLSH"
+#define SHARED_VERSION (2)
+
+#define HASH_NOT_FOUND ((size_t)-1)
 
-#define INVALID_OFFSET ((uint32_t)-1)
+// The threshold at which we perform an index
+// of all of the hashes and perform fast lookup
+#define FAST_LOOKUP_THRESHOLD (65536 * 4)
 
 class HashList
 {
 public:
     HashList(void) = default;
+    ~HashList(void);
     const bool Initialize(const std::filesystem::path Path, const size_t DigestLength, const bool Sort = false);
     const bool Initialize(uint8_t* Base, const size_t Size, const size_t DigestLength, const bool Sort = true);
-    const bool Lookup(const uint8_t* Hash) const;
-    const bool LookupLinear(const uint8_t* Hash) const;
-    const bool LookupFast(const uint8_t* Hash) const;
-    const bool LookupBinary(const uint8_t* Hash) const;
+    // Lookups return the index of the first matching entry
+    // or HASH_NOT_FOUND. The searches are built per ISA level with
+    // the static helpers inlined into each
+    const size_t Lookup(const uint8_t* Hash) const;
+    MULTIVERSION_DECL const size_t LookupLinear(const uint8_t* Hash) const;
+    MULTIVERSION_DECL const size_t LookupFast(const uint8_t* Hash) const;
+    MULTIVERSION_DECL const size_t LookupBinary(const uint8_t* Hash) const;
+    const size_t LookupCompressed(const uint8_t* Hash) const;
     void Sort(void);
     const size_t GetCount(void) const { return m_Count; };
+    const size_t GetUniqueCount(void) const { return m_UniqueCount; };
+    const bool MarkCracked(const size_t Index) { return m_Cracked->Set(Index); };
+    const bool IsCracked(const size_t Index) const { return m_Cracked->Test(Index); };
+    AtomicBitmap& GetCracked(void) { return *m_Cracked; };
     void SetBitmaskSize(const size_t BitmaskSize) { m_BitmaskSize = BitmaskSize; };
     const size_t GetBitmaskSize(void) const { return m_BitmaskSize; };
+    void SetCompressed(const bool Compressed) { m_Compressed = Compressed; };
+    const bool GetCompressed(void) const { return m_Compressed; };
+    void SetHugePages(const bool HugePages) { m_HugePages = HugePages; };
+    // Only map this many leading bytes of a hash file
+    void SetMaxSize(const size_t MaxSize) { m_MaxSize = MaxSize; };
+    // Build the bucket index on a background thread, searching
+    // the whole list until it is ready
+    void SetLazyIndex(const bool LazyIndex) { m_LazyIndex = LazyIndex; };
+    const bool IsIndexReady(void) const { return __atomic_load_n(&m_Offsets, __ATOMIC_ACQUIRE) != nullptr; };
+    void WaitForIndex(void);
+    // True once the list and index live in huge page memory
+    const bool IsHugePageBacked(void) const { return m_HugeRegion != nullptr; };
+    const bool SaveIndex(const std::filesystem::path Path) const;
+    const bool ExportUncracked(const std::filesystem::path Path) const;
+    // Shared memory publishing of the sorted list and index. Publish
+    // keeps the private copy if another process's segment cannot be
+    // used, Attach checks Algorithm unless it is undefined
+    const bool Publish(const std::string Name, const std::string Source, const uint32_t Algorithm);
+    const bool Attach(const std::string Name, const std::string Source, uint32_t& Algorithm);
+    const bool IsShared(void) const { return m_Segment != nullptr; }
+    static const bool SharedExists(const std::string Name);
+    static const bool UnlinkShared(const std::string Name);
+    // Copies the list and index into memory first touched by the
+    // calling thread, sharing the cracked state with this list
+    void Replicate(HashList& Replica) const;
+    const bool LoadIndex(const std::filesystem::path Path);
     // Static
-    static const bool Lookup(const uint8_t* const Base, const size_t Size, const uint8_t* const Hash, const size_t HashSize);
-    static const bool LookupLinear(const uint8_t* const Base, const size_t Size, const uint8_t* const Hash, const size_t HashSize);
+    static void Sort(uint8_t* Base, const size_t Count, const size_t DigestLength);
+    static const std::filesystem::path IndexPath(const std::filesystem::path Path);
+    static const size_t Lookup(const uint8_t* const Base, const size_t Size, const uint8_t* const Hash, const size_t HashSize);
+    static const size_t LookupLinear(const uint8_t* const Base, const size_t Size, const uint8_t* const Hash, const size_t HashSize);
+    static const size_t WriteUncracked(const uint8_t* const Base, const size_t Count, const size_t DigestLength, const AtomicBitmap& Cracked, const size_t First, const bool Binary, FILE* Output, const uint8_t* const Previous = nullptr);
+    static const bool IsBinaryPath(const std::filesystem::path Path);
+    static const size_t CountUnique(const uint8_t* const Base, const size_t Count, const size_t DigestLength, const uint8_t* const Previous = nullptr);
 private:
     const bool InitializeInternal(void);
+    const bool InitializeTables(void);
+    const bool InitializeCompressed(void);
+    MULTIVERSION_DECL const size_t LowerBound(const uint64_t Bucket, size_t Low, size_t High) const;
+    const bool BuildTable(std::stop_token Stop);
+    void IndexRange(const size_t First, const size_t Last, std::stop_token Stop);
+    const bool MoveToHugePages(void);
+    void ReleaseHugeRegion(void);
     std::filesystem::path m_Path;
+    std::filesystem::path m_IndexPath;
     size_t m_DigestLength;
-    FILE* m_BinaryHashFileHandle;
-    uint8_t* m_Base;
-    size_t m_Size;
+    FILE* m_BinaryHashFileHandle = nullptr;
+    uint8_t* m_Base = nullptr;
+    size_t m_Size = 0;
     size_t m_Count;
-    size_t m_BitmaskSize = 16;
-    std::vector<LookupTable> m_LookupTable;
+    size_t m_BitmaskSize = 0;
+    // Bucket i spans [m_LookupTable[i], m_LookupTable[i + 1])
+    std::vector<uint64_t> m_LookupTable;
+    // Points at either m_LookupTable or a shared segment. Only
+    // published once complete when the index is built lazily
+    const uint64_t* m_Offsets = nullptr;
+    bool m_LazyIndex = false;
+    bool m_Compressed = false;
+    EliasFano m_Succinct;
+    size_t m_UniqueCount;
+    // Set for the first entry of each target once it is cracked
+    std::shared_ptr<AtomicBitmap> m_Cracked;
+    bool m_HugePages = false;
+    size_t m_MaxSize = SIZE_MAX;
+    uint8_t* m_HugeRegion = nullptr;
+    size_t m_HugeSize = 0;
+    // Mapping of the shared segment once published or attached
+    uint8_t* m_Segment = nullptr;
+    size_t m_SegmentSize = 0;
+    // Backing storage when this list is a replica
+    std::vector<uint8_t> m_Replica;
+    // Last so that it is stopped before the table is destroyed
+    std::jthread m_Indexer;
 };
 
 #endif //HashList_hpp
\ No newline at end of file
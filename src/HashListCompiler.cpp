@@ -0,0 +1,496 @@
+//
+//  HashListCompiler.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <thread>
+
+#include "HashList.hpp"
+#include "HashListCompiler.hpp"
+#include "Util.hpp"
+
+// Upper bound on the read buffer used for each run while merging
+#define MERGE_BUFFER_SIZE (16 * 1024 * 1024)
+// Output write buffer
+#define OUTPUT_BUFFER_SIZE (8 * 1024 * 1024)
+// Most runs merged at once, more are merged in several passes
+#define MERGE_MAX_FANIN (256)
+// Descriptors left free of the open file limit while merging
+#define MERGE_RESERVED_FILES (16)
+
+typedef struct _MergeCursor
+{
+    FILE* File;
+    std::vector<uint8_t> Buffer;
+    const uint8_t* Position;
+    const uint8_t* End;
+} MergeCursor;
+
+static const bool
+Refill(
+    MergeCursor& Cursor,
+    const size_t DigestLength
+)
+{
+    const size_t read = fread(&Cursor.Buffer[0], DigestLength, Cursor.Buffer.size() / DigestLength, Cursor.File);
+    Cursor.Position = &Cursor.Buffer[0];
+    Cursor.End = Cursor.Position + read * DigestLength;
+    return read > 0;
+}
+
+static const bool
+Advance(
+    MergeCursor& Cursor,
+    const size_t DigestLength
+)
+{
+    Cursor.Position += DigestLength;
+    if (Cursor.Position < Cursor.End)
+    {
+        return true;
+    }
+    if (Cursor.File == nullptr)
+    {
+        return false;
+    }
+    return Refill(Cursor, DigestLength);
+}
+
+//
+// K-way merge of sorted cursors into Output, dropping duplicates.
+// Returns the number of unique digests written.
+//
+static const size_t
+Merge(
+    std::vector<MergeCursor>& Cursors,
+    FILE* Output,
+    const size_t DigestLength
+)
+{
+    auto greater = [&](const size_t a, const size_t b) {
+        return memcmp(Cursors[a].Position, Cursors[b].Position, DigestLength) > 0;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+
+    for (size_t i = 0; i < Cursors.size(); i++)
+    {
+        if (Cursors[i].Position < Cursors[i].End)
+        {
+            heap.push(i);
+        }
+    }
+
+    std::vector<uint8_t> last(DigestLength);
+    size_t written = 0;
+
+    while (!heap.empty())
+    {
+        const size_t next = heap.top();
+        heap.pop();
+
+        MergeCursor& cursor = Cursors[next];
+        if (written == 0 || memcmp(&last[0], cursor.Position, DigestLength) != 0)
+        {
+            memcpy(&last[0], cursor.Position, DigestLength);
+            fwrite(cursor.Position, DigestLength, 1, Output);
+            written++;
+        }
+
+        if (Advance(cursor, DigestLength))
+        {
+            heap.push(next);
+        }
+    }
+
+    return written;
+}
+
+const bool
+HashListCompiler::AddHash(
+    const uint8_t* Hash
+)
+{
+    memcpy(&m_Run[m_RunCount * m_DigestLength], Hash, m_DigestLength);
+    if (++m_RunCount == m_RunCapacity)
+    {
+        return FlushRun();
+    }
+    return true;
+}
+
+const bool
+HashListCompiler::ReadText(
+    const std::filesystem::path Input
+)
+{
+    std::ifstream infile(Input);
+    if (!infile.is_open())
+    {
+        std::cerr << "Error: unable to open " << Input << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(infile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (m_Algorithm == HashAlgorithmUndefined)
+        {
+            m_Algorithm = DetectHashAlgorithmHex(line.size());
+            if (m_Algorithm == HashAlgorithmUndefined)
+            {
+                std::cerr << "Unable to detect hash algorithm" << std::endl;
+                return false;
+            }
+            std::cerr << HashAlgorithmToString(m_Algorithm) << " detected" << std::endl;
+        }
+
+        if (m_Run.empty())
+        {
+            m_DigestLength = GetHashWidth(m_Algorithm);
+            m_RunCapacity = std::max<size_t>(m_MemoryLimit / m_DigestLength, 1);
+            m_Run.resize(m_RunCapacity * m_DigestLength);
+        }
+
+        m_InputCount++;
+
+        if (line.size() != m_DigestLength * 2 || !Util::IsHex(line))
+        {
+            m_Invalid++;
+            continue;
+        }
+
+        auto bytes = Util::ParseHex(line);
+        if (!AddHash(&bytes[0]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const bool
+HashListCompiler::ReadBinary(
+    const std::filesystem::path Input
+)
+{
+    if (m_Algorithm == HashAlgorithmUndefined)
+    {
+        std::cerr << "Error: binary hash list with no algorithm" << std::endl;
+        return false;
+    }
+
+    m_DigestLength = GetHashWidth(m_Algorithm);
+    if (std::filesystem::file_size(Input) % m_DigestLength != 0)
+    {
+        std::cerr << "Error: length of " << Input << " does not match digest" << std::endl;
+        return false;
+    }
+
+    if (m_Run.empty())
+    {
+        m_RunCapacity = std::max<size_t>(m_MemoryLimit / m_DigestLength, 1);
+        m_Run.resize(m_RunCapacity * m_DigestLength);
+    }
+
+    FILE* handle = fopen(Input.c_str(), "rb");
+    if (handle == nullptr)
+    {
+        std::cerr << "Error: unable to open " << Input << std::endl;
+        return false;
+    }
+
+    // Read straight into the free space of the current run
+    size_t read;
+    while ((read = fread(&m_Run[m_RunCount * m_DigestLength], m_DigestLength, m_RunCapacity - m_RunCount, handle)) > 0)
+    {
+        m_InputCount += read;
+        m_RunCount += read;
+        if (m_RunCount == m_RunCapacity && !FlushRun())
+        {
+            fclose(handle);
+            return false;
+        }
+    }
+
+    fclose(handle);
+    return true;
+}
+
+const bool
+HashListCompiler::FlushRun(
+    void
+)
+{
+    if (m_RunCount == 0)
+    {
+        return true;
+    }
+
+    // Sort slices of the run in parallel
+    const size_t slice = (m_RunCount + m_Threads - 1) / m_Threads;
+    std::vector<std::thread> sorters;
+    std::vector<MergeCursor> cursors;
+    for (size_t first = 0; first < m_RunCount; first += slice)
+    {
+        const size_t count = std::min(slice, m_RunCount - first);
+        uint8_t* const base = &m_Run[first * m_DigestLength];
+        sorters.emplace_back(
+            static_cast<void(*)(uint8_t*, const size_t, const size_t)>(&HashList::Sort),
+            base,
+            count,
+            m_DigestLength
+        );
+        cursors.push_back({nullptr, {}, base, base + count * m_DigestLength});
+    }
+
+    for (auto& sorter : sorters)
+    {
+        sorter.join();
+    }
+
+    // Merge the slices into a run file
+    const std::filesystem::path path = NextRunPath();
+    FILE* handle = fopen(path.c_str(), "wb");
+    if (handle == nullptr)
+    {
+        std::cerr << "Error: unable to create temporary file " << path << std::endl;
+        return false;
+    }
+    m_RunFiles.push_back(path);
+
+    setvbuf(handle, nullptr, _IOFBF, OUTPUT_BUFFER_SIZE);
+    const size_t written = Merge(cursors, handle, m_DigestLength);
+    if (fclose(handle) != 0)
+    {
+        std::cerr << "Error: failed writing temporary file " << path << std::endl;
+        return false;
+    }
+
+    std::cerr << "Wrote run " << path.extension().string().substr(4) << " (" << written << " unique hashes)" << std::endl;
+
+    m_RunCount = 0;
+    return true;
+}
+
+const std::filesystem::path
+HashListCompiler::NextRunPath(
+    void
+)
+{
+    return m_TempDirectory / (m_Output.filename().string() + ".run" + std::to_string(m_NextRun++));
+}
+
+const bool
+HashListCompiler::MergeFiles(
+    const std::vector<std::filesystem::path>& Inputs,
+    const std::filesystem::path Output,
+    size_t& Written
+)
+{
+    FILE* output = fopen(Output.c_str(), "wb");
+    if (output == nullptr)
+    {
+        std::cerr << "Error: unable to open " << Output << " for writing" << std::endl;
+        return false;
+    }
+    setvbuf(output, nullptr, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    // Split the memory budget between the run readers
+    size_t bufferSize = std::min<size_t>(m_MemoryLimit / std::max<size_t>(Inputs.size(), 1), MERGE_BUFFER_SIZE);
+    bufferSize = std::max(bufferSize / m_DigestLength, (size_t)1) * m_DigestLength;
+
+    std::vector<MergeCursor> cursors(Inputs.size());
+    bool success = true;
+    for (size_t i = 0; i < Inputs.size(); i++)
+    {
+        cursors[i].File = fopen(Inputs[i].c_str(), "rb");
+        if (cursors[i].File == nullptr)
+        {
+            std::cerr << "Error: unable to open temporary file " << Inputs[i] << std::endl;
+            success = false;
+            break;
+        }
+        cursors[i].Buffer.resize(bufferSize);
+        Refill(cursors[i], m_DigestLength);
+    }
+
+    if (success)
+    {
+        Written = Merge(cursors, output, m_DigestLength);
+    }
+
+    for (auto& cursor : cursors)
+    {
+        if (cursor.File != nullptr)
+        {
+            fclose(cursor.File);
+        }
+    }
+
+    if (fclose(output) != 0)
+    {
+        std::cerr << "Error: failed writing " << Output << std::endl;
+        success = false;
+    }
+
+    return success;
+}
+
+const bool
+HashListCompiler::MergeRuns(
+    void
+)
+{
+    // A single run is already sorted and unique
+    if (m_RunFiles.size() == 1)
+    {
+        std::error_code error;
+        std::filesystem::rename(m_RunFiles[0], m_Output, error);
+        if (!error)
+        {
+            m_RunFiles.clear();
+            return true;
+        }
+    }
+
+    // Every run is open at once, so stay within the open file limit
+    size_t fanIn = MERGE_MAX_FANIN;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+    {
+        fanIn = std::min<size_t>(fanIn, std::max<size_t>(limit.rlim_cur, MERGE_RESERVED_FILES + 2) - MERGE_RESERVED_FILES);
+    }
+
+    // Merge the oldest runs into a new one until few enough are left
+    size_t written = 0;
+    while (m_RunFiles.size() > fanIn)
+    {
+        const std::vector<std::filesystem::path> group(m_RunFiles.begin(), m_RunFiles.begin() + fanIn);
+        const std::filesystem::path path = NextRunPath();
+        m_RunFiles.push_back(path);
+        if (!MergeFiles(group, path, written))
+        {
+            return false;
+        }
+
+        for (auto& run : group)
+        {
+            std::filesystem::remove(run);
+        }
+        m_RunFiles.erase(m_RunFiles.begin(), m_RunFiles.begin() + fanIn);
+
+        std::cerr << "Merged " << group.size() << " runs into run " << path.extension().string().substr(4) << " (" << written << " unique hashes)" << std::endl;
+    }
+
+    if (!MergeFiles(m_RunFiles, m_Output, written))
+    {
+        return false;
+    }
+
+    std::cerr << "Merged " << m_RunFiles.size() << " runs (" << written << " unique hashes)" << std::endl;
+    return true;
+}
+
+const bool
+HashListCompiler::Compile(
+    void
+)
+{
+    if (m_Inputs.empty() || m_Output.empty())
+    {
+        std::cerr << "Error: compile requires at least one input and an output file" << std::endl;
+        return false;
+    }
+
+    // hardware_concurrency() may be 0 if it cannot be determined
+    if (m_Threads == 0)
+    {
+        m_Threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    if (m_TempDirectory.empty())
+    {
+        m_TempDirectory = m_Output.has_parent_path() ? m_Output.parent_path() : ".";
+    }
+
+    bool success = true;
+    for (auto& input : m_Inputs)
+    {
+        std::cerr << "Reading " << input << std::endl;
+        const std::string name = input.string();
+        if (name.ends_with(".bin") || name.ends_with(".dat"))
+        {
+            success = ReadBinary(input);
+        }
+        else
+        {
+            success = ReadText(input);
+        }
+
+        if (!success)
+        {
+            break;
+        }
+    }
+
+    success = success && FlushRun();
+    // Free the run buffer before merging
+    m_Run = std::vector<uint8_t>();
+
+    if (success && m_RunFiles.empty())
+    {
+        std::cerr << "Error: no valid hashes found" << std::endl;
+        success = false;
+    }
+
+    success = success && MergeRuns();
+
+    for (auto& run : m_RunFiles)
+    {
+        std::filesystem::remove(run);
+    }
+
+    if (!success)
+    {
+        return false;
+    }
+
+    std::cerr << "Read " << m_InputCount << " hashes, skipped " << m_Invalid << " invalid" << std::endl;
+
+    // Any existing index belongs to the previous contents
+    const std::filesystem::path index = HashList::IndexPath(m_Output);
+    std::filesystem::remove(index);
+
+    if (m_BuildIndex)
+    {
+        HashList list;
+        list.SetBitmaskSize(m_BitmaskSize);
+        if (!list.Initialize(m_Output, m_DigestLength) || !list.SaveIndex(index))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
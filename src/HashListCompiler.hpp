@@ -0,0 +1,64 @@
+//
+//  HashListCompiler.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef HashListCompiler_hpp
+#define HashListCompiler_hpp
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "simdhash.h"
+
+//
+// Converts hex or binary hash lists of any size into the sorted,
+// deduplicated binary format that HashList maps directly. Input is
+// sorted in bounded memory runs which are then merged from disk.
+//
+class HashListCompiler
+{
+public:
+    HashListCompiler(void) = default;
+    void AddInput(const std::filesystem::path Input) { m_Inputs.push_back(Input); }
+    void SetOutput(const std::filesystem::path Output) { m_Output = Output; }
+    void SetAlgorithm(const HashAlgorithm Algorithm) { m_Algorithm = Algorithm; }
+    void SetMemoryLimit(const size_t MemoryLimit) { m_MemoryLimit = MemoryLimit; }
+    void SetThreads(const size_t Threads) { m_Threads = Threads; }
+    void SetTempDirectory(const std::filesystem::path TempDirectory) { m_TempDirectory = TempDirectory; }
+    void SetBuildIndex(const bool BuildIndex) { m_BuildIndex = BuildIndex; }
+    void SetBitmaskSize(const size_t BitmaskSize) { m_BitmaskSize = BitmaskSize; }
+    const std::filesystem::path GetOutput(void) const { return m_Output; }
+    const HashAlgorithm GetAlgorithm(void) const { return m_Algorithm; }
+    const bool Compile(void);
+private:
+    const bool ReadText(const std::filesystem::path Input);
+    const bool ReadBinary(const std::filesystem::path Input);
+    const bool AddHash(const uint8_t* Hash);
+    const bool FlushRun(void);
+    const std::filesystem::path NextRunPath(void);
+    const bool MergeFiles(const std::vector<std::filesystem::path>& Inputs, const std::filesystem::path Output, size_t& Written);
+    const bool MergeRuns(void);
+    std::vector<std::filesystem::path> m_Inputs;
+    std::filesystem::path m_Output;
+    std::filesystem::path m_TempDirectory;
+    HashAlgorithm m_Algorithm = HashAlgorithmUndefined;
+    size_t m_DigestLength = 0;
+    size_t m_MemoryLimit = 1024 * 1024 * 1024;
+    size_t m_Threads = 0;
+    bool m_BuildIndex = false;
+    size_t m_BitmaskSize = 0;
+    std::vector<uint8_t> m_Run;
+    size_t m_RunCount = 0;
+    size_t m_RunCapacity = 0;
+    std::vector<std::filesystem::path> m_RunFiles;
+    size_t m_NextRun = 0;
+    size_t m_InputCount = 0;
+    size_t m_Invalid = 0;
+};
+
+#endif //HashListCompiler_hpp
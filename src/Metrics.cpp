@@ -0,0 +1,203 @@
+//
+//  Metrics.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <bit>
+
+#include "Metrics.hpp"
+
+const size_t
+LatencyHistogram::BucketIndex(
+    const uint64_t Value
+)
+{
+    if (Value < HISTOGRAM_LINEAR_LIMIT)
+    {
+        return Value;
+    }
+    const size_t exponent = 63 - std::countl_zero(Value);
+    const size_t sub = (Value >> (exponent - 3)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return HISTOGRAM_LINEAR_LIMIT + (exponent - 4) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+const uint64_t
+LatencyHistogram::BucketValue(
+    const size_t Index
+)
+{
+    if (Index < HISTOGRAM_LINEAR_LIMIT)
+    {
+        return Index;
+    }
+    const size_t exponent = (Index - HISTOGRAM_LINEAR_LIMIT) / HISTOGRAM_SUB_BUCKETS + 4;
+    const size_t sub = (Index - HISTOGRAM_LINEAR_LIMIT) % HISTOGRAM_SUB_BUCKETS;
+    // Middle of the bucket
+    const uint64_t low = (uint64_t)(HISTOGRAM_SUB_BUCKETS + sub) << (exponent - 3);
+    return low + ((1ull << (exponent - 3)) >> 1);
+}
+
+void
+LatencyHistogram::Record(
+    const uint64_t Value
+)
+{
+    auto& bucket = m_Buckets[BucketIndex(Value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_Count.store(m_Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_Sum.store(m_Sum.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+    if (Value > m_Max.load(std::memory_order_relaxed))
+    {
+        m_Max.store(Value, std::memory_order_relaxed);
+    }
+}
+
+void
+LatencyHistogram::Merge(
+    const LatencyHistogram& Other
+)
+{
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        m_Buckets[i] += Other.m_Buckets[i].load(std::memory_order_relaxed);
+    }
+    m_Count += Other.GetCount();
+    m_Sum += Other.GetSum();
+    m_Max = std::max(GetMax(), Other.GetMax());
+}
+
+const uint64_t
+LatencyHistogram::Percentile(
+    const double Percent
+) const
+{
+    uint64_t total = 0;
+    for (auto& bucket : m_Buckets)
+    {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+
+    const uint64_t target = (uint64_t)(total * Percent / 100);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += m_Buckets[i].load(std::memory_order_relaxed);
+        if (seen > target)
+        {
+            return std::min(BucketValue(i), GetMax());
+        }
+    }
+    return GetMax();
+}
+
+void
+Metrics::Reset(
+    const size_t Workers
+)
+{
+    m_Threads.clear();
+    // The extra slot belongs to the reader
+    for (size_t i = 0; i < Workers + 1; i++)
+    {
+        m_Threads.push_back(std::make_unique<ThreadMetrics>());
+    }
+    m_QueueDepth = 0;
+    m_MaxQueueDepth = 0;
+    m_Start = std::chrono::steady_clock::now();
+}
+
+void
+Metrics::SetQueueDepth(
+    const size_t Depth
+)
+{
+    m_QueueDepth = Depth;
+    if (Depth > m_MaxQueueDepth)
+    {
+        m_MaxQueueDepth = Depth;
+    }
+}
+
+const uint64_t
+Metrics::GetCandidates(
+    void
+) const
+{
+    uint64_t candidates = 0;
+    for (auto& thread : m_Threads)
+    {
+        candidates += thread->Candidates.load(std::memory_order_relaxed);
+    }
+    return candidates;
+}
+
+const uint64_t
+Metrics::GetElapsedMs(
+    void
+) const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_Start).count();
+}
+
+const char*
+Metrics::StageToString(
+    const PipelineStage Stage
+)
+{
+    switch (Stage)
+    {
+        case StageRead:
+            return "read";
+        case StagePack:
+            return "pack";
+        case StageHash:
+            return "hash";
+        case StageLookup:
+            return "lookup";
+        case StageOutput:
+            return "output";
+        default:
+            return "unknown";
+    }
+}
+
+void
+Metrics::WriteJson(
+    std::ostream& Output
+) const
+{
+    Output << "\"queue_depth\":" << m_QueueDepth << ",\"max_queue_depth\":" << m_MaxQueueDepth;
+
+    // Stage latencies across every thread in microseconds
+    Output << ",\"stages\":{";
+    for (size_t stage = 0; stage < StageCount; stage++)
+    {
+        LatencyHistogram merged;
+        for (auto& thread : m_Threads)
+        {
+            merged.Merge(thread->Stages[stage]);
+        }
+        const uint64_t count = merged.GetCount();
+        Output << (stage ? "," : "") << "\"" << StageToString((PipelineStage)stage) << "\":{";
+        Output << "\"count\":" << count;
+        Output << ",\"total_ms\":" << merged.GetSum() / 1000000;
+        Output << ",\"mean_us\":" << (count ? (double)merged.GetSum() / count / 1000 : 0);
+        Output << ",\"p50_us\":" << (double)merged.Percentile(50) / 1000;
+        Output << ",\"p99_us\":" << (double)merged.Percentile(99) / 1000;
+        Output << ",\"max_us\":" << (double)merged.GetMax() / 1000 << "}";
+    }
+    Output << "}";
+
+    // Per worker counters, the reader is not included
+    Output << ",\"workers\":[";
+    for (size_t i = 0; i + 1 < m_Threads.size(); i++)
+    {
+        Output << (i ? "," : "") << "{\"candidates\":" << m_Threads[i]->Candidates;
+        Output << ",\"blocks\":" << m_Threads[i]->Blocks;
+        Output << ",\"hits\":" << m_Threads[i]->Hits << "}";
+    }
+    Output << "]";
+}
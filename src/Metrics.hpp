@@ -0,0 +1,121 @@
+//
+//  Metrics.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef Metrics_hpp
+#define Metrics_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+typedef enum
+{
+    StageRead,
+    StagePack,
+    StageHash,
+    StageLookup,
+    StageOutput,
+    StageCount
+} PipelineStage;
+
+// Values below this are counted exactly, above it each power
+// of two is split into HISTOGRAM_SUB_BUCKETS linear buckets
+#define HISTOGRAM_LINEAR_LIMIT (16)
+#define HISTOGRAM_SUB_BUCKETS (8)
+#define HISTOGRAM_BUCKETS (HISTOGRAM_LINEAR_LIMIT + (64 - 4) * HISTOGRAM_SUB_BUCKETS)
+
+//
+// Log-linear latency histogram in nanoseconds with roughly 12%
+// precision. Written by one thread, readable from any.
+//
+class LatencyHistogram
+{
+public:
+    LatencyHistogram(void) = default;
+    void Record(const uint64_t Value);
+    // Adds the counts of Other into this histogram
+    void Merge(const LatencyHistogram& Other);
+    const uint64_t GetCount(void) const { return m_Count.load(std::memory_order_relaxed); }
+    const uint64_t GetSum(void) const { return m_Sum.load(std::memory_order_relaxed); }
+    const uint64_t GetMax(void) const { return m_Max.load(std::memory_order_relaxed); }
+    const uint64_t Percentile(const double Percent) const;
+private:
+    static const size_t BucketIndex(const uint64_t Value);
+    static const uint64_t BucketValue(const size_t Index);
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> m_Buckets = {};
+    std::atomic<uint64_t> m_Count = 0;
+    std::atomic<uint64_t> m_Sum = 0;
+    std::atomic<uint64_t> m_Max = 0;
+};
+
+// Counters for one thread, padded to keep writers apart
+struct alignas(64) ThreadMetrics
+{
+    std::array<LatencyHistogram, StageCount> Stages;
+    std::atomic<uint64_t> Candidates = 0;
+    std::atomic<uint64_t> Blocks = 0;
+    std::atomic<uint64_t> Hits = 0;
+    // Single writer so a relaxed load and store is enough
+    void Add(std::atomic<uint64_t>& Counter, const uint64_t Value) { Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed); }
+};
+
+//
+// Times a pipeline stage for the lifetime of the object
+//
+class StageTimer
+{
+public:
+    StageTimer(ThreadMetrics* Metrics, const PipelineStage Stage) : m_Metrics(Metrics), m_Stage(Stage)
+    {
+        if (m_Metrics != nullptr)
+        {
+            m_Start = std::chrono::steady_clock::now();
+        }
+    };
+    ~StageTimer(void)
+    {
+        if (m_Metrics != nullptr)
+        {
+            m_Metrics->Stages[m_Stage].Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count());
+        }
+    };
+private:
+    ThreadMetrics* m_Metrics;
+    PipelineStage m_Stage;
+    std::chrono::steady_clock::time_point m_Start;
+};
+
+//
+// Pipeline instrumentation for a run: a ThreadMetrics per worker
+// plus one for the reader, and the input queue depth gauge
+//
+class Metrics
+{
+public:
+    Metrics(void) = default;
+    void Reset(const size_t Workers);
+    ThreadMetrics* GetWorker(const size_t Worker) { return m_Threads[Worker].get(); }
+    ThreadMetrics* GetReader(void) { return m_Threads.back().get(); }
+    void SetQueueDepth(const size_t Depth);
+    const size_t GetQueueDepth(void) const { return m_QueueDepth; }
+    const uint64_t GetCandidates(void) const;
+    const uint64_t GetElapsedMs(void) const;
+    void WriteJson(std::ostream& Output) const;
+    static const char* StageToString(const PipelineStage Stage);
+private:
+    std::vector<std::unique_ptr<ThreadMetrics>> m_Threads;
+    std::atomic<size_t> m_QueueDepth = 0;
+    std::atomic<size_t> m_MaxQueueDepth = 0;
+    std::chrono::steady_clock::time_point m_Start = std::chrono::steady_clock::now();
+};
+
+#endif //Metrics_hpp
@@ -0,0 +1,76 @@
+//
+//  PerfCounter.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "PerfCounter.hpp"
+
+PerfCounter::~PerfCounter(
+    void
+)
+{
+    if (m_Fd >= 0)
+    {
+        close(m_Fd);
+    }
+}
+
+const bool
+PerfCounter::Open(
+    const uint32_t Type,
+    const uint64_t Config
+)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = Type;
+    attr.size = sizeof(attr);
+    attr.config = Config;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    m_Fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    return m_Fd >= 0;
+}
+
+const uint64_t
+PerfCounter::Read(
+    void
+) const
+{
+    uint64_t value = 0;
+    if (m_Fd < 0 || read(m_Fd, &value, sizeof(value)) != sizeof(value))
+    {
+        return 0;
+    }
+    return value;
+}
+
+const uint64_t
+PerfCounter::DtlbLoads(
+    void
+)
+{
+    return PERF_COUNT_HW_CACHE_DTLB |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16);
+}
+
+const uint64_t
+PerfCounter::DtlbMisses(
+    void
+)
+{
+    return PERF_COUNT_HW_CACHE_DTLB |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
@@ -0,0 +1,36 @@
+//
+//  PerfCounter.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef PerfCounter_hpp
+#define PerfCounter_hpp
+
+#include <cstdint>
+
+//
+// Hardware event counter for this process via perf_event_open.
+// Threads created after Open() are counted too; their counts are
+// folded in as they exit.
+//
+class PerfCounter
+{
+public:
+    PerfCounter(void) = default;
+    ~PerfCounter(void);
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+    const bool Open(const uint32_t Type, const uint64_t Config);
+    const bool IsOpen(void) const { return m_Fd >= 0; }
+    const uint64_t Read(void) const;
+    // Data TLB read accesses and misses
+    static const uint64_t DtlbLoads(void);
+    static const uint64_t DtlbMisses(void);
+private:
+    int m_Fd = -1;
+};
+
+#endif //PerfCounter_hpp
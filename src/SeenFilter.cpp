@@ -0,0 +1,81 @@
+//
+//  SeenFilter.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <bit>
+#include <string.h>
+
+#include "SeenFilter.hpp"
+
+static inline const uint64_t
+Mix(
+    uint64_t Value
+)
+{
+    Value ^= Value >> 33;
+    Value *= 0xff51afd7ed558ccdull;
+    Value ^= Value >> 33;
+    Value *= 0xc4ceb9fe1a85ec53ull;
+    Value ^= Value >> 33;
+    return Value;
+}
+
+const uint64_t
+SeenFilter::Hash(
+    const uint8_t* Data,
+    const size_t Length
+)
+{
+    uint64_t hash = 0x9e3779b97f4a7c15ull ^ Length;
+    size_t i = 0;
+    for (; i + 8 <= Length; i += 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, Data + i, sizeof(chunk));
+        hash = std::rotl(hash ^ Mix(chunk), 27) * 0x9e3779b97f4a7c15ull;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, Data + i, Length - i);
+    return Mix(hash ^ tail);
+}
+
+SeenFilter::SeenFilter(
+    const size_t Bytes
+)
+{
+    // Round down to a power of two so a mask selects the bucket
+    m_Buckets = std::bit_floor(std::max<size_t>(Bytes / sizeof(Bucket), 1));
+    m_Table = std::make_unique<Bucket[]>(m_Buckets);
+}
+
+const bool
+SeenFilter::Insert(
+    const std::string& Word
+)
+{
+    const uint64_t hash = Hash((const uint8_t*)Word.data(), Word.size());
+    Bucket& bucket = m_Table[hash & (m_Buckets - 1)];
+    // Zero marks an empty slot
+    const uint32_t fingerprint = (uint32_t)(hash >> 32) | 1;
+
+    for (size_t i = 0; i < SEEN_BUCKET_SLOTS; i++)
+    {
+        uint32_t slot = bucket.Slots[i].load(std::memory_order_relaxed);
+        if (slot == 0 && bucket.Slots[i].compare_exchange_strong(slot, fingerprint, std::memory_order_relaxed))
+        {
+            return true;
+        }
+        // Either already present or another thread claimed the slot
+        if (slot == fingerprint)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,44 @@
+//
+//  SeenFilter.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef SeenFilter_hpp
+#define SeenFilter_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Fingerprint slots per bucket, one cache line
+#define SEEN_BUCKET_SLOTS (16)
+
+//
+// Lock free approximate set of words already seen. Each word is
+// reduced to a 32 bit fingerprint stored in a cache line sized
+// bucket, so a distinct word is wrongly reported as seen with a
+// probability of roughly SEEN_BUCKET_SLOTS / 2^32. Once a bucket
+// fills, further words in it are always treated as new.
+//
+class SeenFilter
+{
+public:
+    SeenFilter(const size_t Bytes);
+    // Returns true the first time a word is inserted
+    const bool Insert(const std::string& Word);
+    const size_t GetSizeBytes(void) const { return m_Buckets * SEEN_BUCKET_SLOTS * sizeof(uint32_t); }
+    static const uint64_t Hash(const uint8_t* Data, const size_t Length);
+private:
+    struct alignas(64) Bucket
+    {
+        std::atomic<uint32_t> Slots[SEEN_BUCKET_SLOTS];
+    };
+    size_t m_Buckets;
+    std::unique_ptr<Bucket[]> m_Table;
+};
+
+#endif //SeenFilter_hpp
@@ -0,0 +1,123 @@
+//
+//  Topology.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+#include "Topology.hpp"
+
+#define NODE_SYSFS_PATH "/sys/devices/system/node"
+
+std::vector<size_t>
+Topology::ParseCpuList(
+    const std::string List
+)
+{
+    // Comma separated CPUs and ranges, e.g. "0-3,8-11"
+    std::vector<size_t> cpus;
+    size_t position = 0;
+    while (position < List.size())
+    {
+        size_t end = List.find(',', position);
+        if (end == std::string::npos)
+        {
+            end = List.size();
+        }
+
+        const std::string item = List.substr(position, end - position);
+        const size_t dash = item.find('-');
+        if (!item.empty() && isdigit(item[0]))
+        {
+            const size_t first = std::stoul(item);
+            const size_t last = dash == std::string::npos ? first : std::stoul(item.substr(dash + 1));
+            for (size_t cpu = first; cpu <= last; cpu++)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+
+        position = end + 1;
+    }
+    return cpus;
+}
+
+const bool
+Topology::Detect(
+    void
+)
+{
+    m_Nodes.clear();
+
+    std::error_code error;
+    for (auto& entry : std::filesystem::directory_iterator(NODE_SYSFS_PATH, error))
+    {
+        const std::string name = entry.path().filename().string();
+        if (!name.starts_with("node") || name.size() == 4 || !isdigit(name[4]))
+        {
+            continue;
+        }
+
+        std::ifstream cpulist(entry.path() / "cpulist");
+        std::string line;
+        std::getline(cpulist, line);
+
+        NumaNode node;
+        node.Id = std::stoul(name.substr(4));
+        node.Cpus = ParseCpuList(line);
+        // Memory only nodes have nothing to run workers on
+        if (!node.Cpus.empty())
+        {
+            m_Nodes.push_back(std::move(node));
+        }
+    }
+
+    std::sort(m_Nodes.begin(), m_Nodes.end(),
+        [](const NumaNode& a, const NumaNode& b) { return a.Id < b.Id; });
+
+    if (m_Nodes.empty())
+    {
+        NumaNode node;
+        node.Id = 0;
+        for (size_t cpu = 0; cpu < std::thread::hardware_concurrency(); cpu++)
+        {
+            node.Cpus.push_back(cpu);
+        }
+        m_Nodes.push_back(std::move(node));
+        return false;
+    }
+
+    return true;
+}
+
+const size_t
+Topology::WorkerCpu(
+    const size_t Worker
+) const
+{
+    const NumaNode& node = m_Nodes[WorkerNode(Worker)];
+    return node.Cpus[(Worker / m_Nodes.size()) % node.Cpus.size()];
+}
+
+const bool
+Topology::PinThread(
+    const std::vector<size_t>& Cpus
+)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const size_t cpu : Cpus)
+    {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
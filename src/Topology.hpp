@@ -0,0 +1,41 @@
+//
+//  Topology.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef Topology_hpp
+#define Topology_hpp
+
+#include <string>
+#include <vector>
+
+typedef struct _NumaNode
+{
+    size_t Id;
+    std::vector<size_t> Cpus;
+} NumaNode;
+
+//
+// NUMA layout of the machine as described by sysfs. Workers are
+// spread round robin over the nodes and then over each node's CPUs.
+//
+class Topology
+{
+public:
+    Topology(void) = default;
+    // Falls back to a single node holding every CPU
+    const bool Detect(void);
+    const size_t GetNodeCount(void) const { return m_Nodes.size(); }
+    const NumaNode& GetNode(const size_t Index) const { return m_Nodes[Index]; }
+    const size_t WorkerNode(const size_t Worker) const { return Worker % m_Nodes.size(); }
+    const size_t WorkerCpu(const size_t Worker) const;
+    static const bool PinThread(const std::vector<size_t>& Cpus);
+    static std::vector<size_t> ParseCpuList(const std::string List);
+private:
+    std::vector<NumaNode> m_Nodes;
+};
+
+#endif //Topology_hpp
@@ -0,0 +1,156 @@
+//
+//  Trace.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Trace.hpp"
+
+#ifdef CRACKLIST_TRACE
+#include <chrono>
+
+typedef struct _TraceEvent
+{
+    const char* Name;
+    uint64_t Begin;
+    uint64_t End;
+} TraceEvent;
+
+// Only ever appended to by the thread that owns it
+typedef struct _ThreadBuffer
+{
+    std::string Name;
+    size_t Id;
+    size_t Dropped;
+    std::vector<TraceEvent> Events;
+} ThreadBuffer;
+
+// Buffers outlive their threads so they can be written at exit
+static std::mutex s_BuffersMutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+static thread_local ThreadBuffer* t_Buffer = nullptr;
+static const auto s_Epoch = std::chrono::steady_clock::now();
+
+static ThreadBuffer*
+GetBuffer(
+    void
+)
+{
+    if (t_Buffer == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+        s_Buffers.push_back(std::make_unique<ThreadBuffer>());
+        t_Buffer = s_Buffers.back().get();
+        t_Buffer->Id = s_Buffers.size();
+        t_Buffer->Name = "thread " + std::to_string(t_Buffer->Id);
+        t_Buffer->Dropped = 0;
+        t_Buffer->Events.reserve(4096);
+    }
+    return t_Buffer;
+}
+
+const uint64_t
+Trace::Now(
+    void
+)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+}
+
+void
+Trace::NameThread(
+    const char* Name,
+    const size_t Index
+)
+{
+    GetBuffer()->Name = std::string(Name) + " " + std::to_string(Index);
+}
+
+void
+Trace::Record(
+    const char* Name,
+    const uint64_t Begin,
+    const uint64_t End
+)
+{
+    ThreadBuffer* const buffer = GetBuffer();
+    if (buffer->Events.size() >= TRACE_MAX_EVENTS)
+    {
+        buffer->Dropped++;
+        return;
+    }
+    buffer->Events.push_back({Name, Begin, End});
+}
+#endif
+
+const bool
+Trace::Enabled(
+    void
+)
+{
+#ifdef CRACKLIST_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+const bool
+Trace::Dump(
+    const std::filesystem::path Path
+)
+{
+#ifdef CRACKLIST_TRACE
+    std::ofstream output(Path, std::ios::out | std::ios::trunc);
+    if (!output)
+    {
+        std::cerr << "Error: unable to open trace file " << Path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+    size_t events = 0;
+    size_t dropped = 0;
+    bool first = true;
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (auto& buffer : s_Buffers)
+    {
+        output << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->Id;
+        output << ",\"args\":{\"name\":\"" << buffer->Name << "\"}}";
+        first = false;
+
+        // Complete events, timestamps are in microseconds
+        for (auto& event : buffer->Events)
+        {
+            output << ",\n{\"name\":\"" << event.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->Id;
+            output << ",\"ts\":" << event.Begin / 1000 << "." << event.Begin % 1000 / 100;
+            output << ",\"dur\":" << (event.End - event.Begin) / 1000 << "." << (event.End - event.Begin) % 1000 / 100 << "}";
+        }
+        events += buffer->Events.size();
+        dropped += buffer->Dropped;
+    }
+    output << "\n]}\n";
+    output.close();
+
+    std::cerr << "Wrote " << events << " trace events to " << Path;
+    if (dropped != 0)
+    {
+        std::cerr << " (" << dropped << " dropped)";
+    }
+    std::cerr << std::endl;
+    return !output.fail();
+#else
+    (void)Path;
+    std::cerr << "Warning: built without CRACKLIST_TRACE, no trace written" << std::endl;
+    return false;
+#endif
+}
@@ -0,0 +1,57 @@
+//
+//  Trace.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef Trace_hpp
+#define Trace_hpp
+
+#include <cstdint>
+#include <filesystem>
+
+//
+// Timeline of what every thread was doing, written as a Chrome
+// trace (chrome://tracing, ui.perfetto.dev). Only compiled in when
+// CRACKLIST_TRACE is defined, otherwise the macros are empty.
+//
+#ifdef CRACKLIST_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+// Records a span from here to the end of the enclosing scope
+#define TRACE_SPAN(Name) Trace::Span TRACE_CONCAT(_traceSpan, __LINE__)(Name)
+#define TRACE_THREAD(Name, Index) Trace::NameThread(Name, Index)
+#else
+#define TRACE_SPAN(Name) do {} while (0)
+#define TRACE_THREAD(Name, Index) do {} while (0)
+#endif
+
+// Each thread keeps at most this many spans, later ones are dropped
+#define TRACE_MAX_EVENTS (1 << 20)
+
+namespace Trace
+{
+    const bool Enabled(void);
+    // Writes every thread's spans to Path, once the threads are done
+    const bool Dump(const std::filesystem::path Path);
+
+#ifdef CRACKLIST_TRACE
+    const uint64_t Now(void);
+    void NameThread(const char* Name, const size_t Index);
+    void Record(const char* Name, const uint64_t Begin, const uint64_t End);
+
+    class Span
+    {
+    public:
+        Span(const char* Name) : m_Name(Name), m_Begin(Now()) {};
+        ~Span(void) { Record(m_Name, m_Begin, Now()); };
+    private:
+        const char* m_Name;
+        uint64_t m_Begin;
+    };
+#endif
+};
+
+#endif //Trace_hpp
@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "CpuFeatures.hpp"
 #include "Util.hpp"
 
 namespace Util
@@ -61,19 +62,26 @@ ToHex(
 	const size_t Length
 )
 {
-	char buffer[3];
-	std::string ret;
-
-	buffer[2] = '\0';
+	std::string ret(Length * 2, '\0');
+	ToHex(Bytes, Length, &ret[0]);
+	return ret;
+}
 
+MULTIVERSION void
+ToHex(
+	const uint8_t* Bytes,
+	const size_t Length,
+	char* Output
+)
+{
+	// Branch free so that it vectorises
 	for (size_t i = 0; i < Length; i++)
 	{
-		snprintf(buffer, 3, "%02x", Bytes[i]);
-		ret.push_back(buffer[0]);
-		ret.push_back(buffer[1]);
+		const uint8_t high = Bytes[i] >> 4;
+		const uint8_t low = Bytes[i] & 0xf;
+		Output[i * 2] = high + '0' + (high > 9) * ('a' - '0' - 10);
+		Output[i * 2 + 1] = low + '0' + (low > 9) * ('a' - '0' - 10);
 	}
-
-	return ret;
 }
 
 bool
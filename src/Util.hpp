@@ -14,6 +14,8 @@
 #include <cstdint>
 #include <gmpxx.h>
 
+#include "CpuFeatures.hpp"
+
 namespace Util
 {
 
@@ -28,6 +30,14 @@ ToHex(
     const size_t Length
 );
 
+// Writes Length * 2 lowercase hex characters to Output
+MULTIVERSION_DECL void
+ToHex(
+    const uint8_t* Bytes,
+    const size_t Length,
+    char* Output
+);
+
 bool
 IsHex(
     const std::string& String
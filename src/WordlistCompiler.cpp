@@ -0,0 +1,168 @@
+//
+//  WordlistCompiler.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#include <fstream>
+#include <iostream>
+#include <string.h>
+
+#include "CpuFeatures.hpp"
+#include "Util.hpp"
+#include "WordlistCompiler.hpp"
+
+// Output write buffer
+#define OUTPUT_BUFFER_SIZE (8 * 1024 * 1024)
+
+const bool
+WordlistCompiler::AddWord(
+    const std::string& Word
+)
+{
+    // Adjacent duplicates are always dropped, as when reading text
+    if (Word == m_LastWord || (m_Dedup && !m_Seen.insert(Word).second))
+    {
+        m_Duplicates++;
+        return true;
+    }
+    m_LastWord = Word;
+
+    if (Word.size() > WORDLIST_MAX_WORD)
+    {
+        m_TooLong++;
+        return true;
+    }
+
+    if (m_WordCount % m_BlockSize == 0)
+    {
+        m_Index.push_back(m_Offset);
+    }
+
+    const uint8_t length[sizeof(uint16_t)] = {(uint8_t)Word.size(), (uint8_t)(Word.size() >> 8)};
+    fwrite(length, 1, sizeof(length), m_Handle);
+    fwrite(Word.data(), 1, Word.size(), m_Handle);
+    m_Offset += sizeof(length) + Word.size();
+    m_WordCount++;
+
+    return ferror(m_Handle) == 0;
+}
+
+const bool
+WordlistCompiler::Compile(
+    void
+)
+{
+    if (m_Input.empty() || m_Output.empty())
+    {
+        std::cerr << "Error: compile-wordlist requires an input and an output file" << std::endl;
+        return false;
+    }
+
+    if (m_BlockSize == 0)
+    {
+        m_BlockSize = WORDLIST_BLOCK_SIZE;
+    }
+
+    if (m_BlockSize % CpuFeatures::Lanes() != 0 || m_BlockSize > UINT32_MAX)
+    {
+        std::cerr << "Error: Block Size must be a multiple of Simd Lanes (" << CpuFeatures::Lanes() << ")" << std::endl;
+        return false;
+    }
+
+    std::ifstream input(m_Input, std::ios::in | std::ios::binary);
+    if (!input.is_open())
+    {
+        std::cerr << "Error: unable to open " << m_Input << std::endl;
+        return false;
+    }
+
+    // Written next to the output and renamed once complete
+    const std::filesystem::path temporary = m_Output.string() + ".tmp";
+    m_Handle = fopen(temporary.c_str(), "wb");
+    if (m_Handle == nullptr)
+    {
+        std::cerr << "Error: unable to open " << temporary << " for writing" << std::endl;
+        return false;
+    }
+    setvbuf(m_Handle, nullptr, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    WordlistHeader header = {};
+    fwrite(&header, sizeof(header), 1, m_Handle);
+    m_Offset = sizeof(header);
+
+    std::cerr << "Compiling " << m_Input << std::endl;
+
+    bool success = true;
+    std::string line;
+    while (success && std::getline(input, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (m_ParseHexInput && line.starts_with("$HEX[") && line.back() == ']')
+        {
+            auto bytes = Util::ParseHex(line.substr(5, line.size() - 6));
+            line = std::string(bytes.begin(), bytes.end());
+        }
+
+        success = AddWord(line);
+    }
+
+    // The set is no longer needed and may be very large
+    m_Seen = std::unordered_set<std::string>();
+
+    const uint64_t dataEnd = m_Offset;
+    if (success)
+    {
+        // Pad so the index can be read in place
+        const uint8_t padding[sizeof(uint64_t)] = {0};
+        m_Offset = (dataEnd + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+        fwrite(padding, 1, m_Offset - dataEnd, m_Handle);
+
+        memcpy(header.Magic, WORDLIST_MAGIC, sizeof(header.Magic));
+        header.Version = WORDLIST_VERSION;
+        header.Flags = (m_ParseHexInput ? WORDLIST_FLAG_HEX : 0) | (m_Dedup ? WORDLIST_FLAG_DEDUP : 0);
+        header.BlockSize = m_BlockSize;
+        header.WordCount = m_WordCount;
+        header.BlockCount = m_Index.size();
+        header.DataOffset = sizeof(header);
+        header.IndexOffset = m_Offset;
+        header.SourceSize = std::filesystem::file_size(m_Input);
+
+        m_Index.push_back(dataEnd);
+        fwrite(&m_Index[0], sizeof(uint64_t), m_Index.size(), m_Handle);
+
+        // The magic is only written once everything else is
+        success = fseek(m_Handle, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, m_Handle) == 1;
+    }
+
+    if (fclose(m_Handle) != 0 || !success)
+    {
+        std::cerr << "Error: failed writing " << temporary << std::endl;
+        std::filesystem::remove(temporary);
+        return false;
+    }
+    m_Handle = nullptr;
+
+    std::error_code error;
+    std::filesystem::rename(temporary, m_Output, error);
+    if (error)
+    {
+        std::cerr << "Error: unable to rename " << temporary << " to " << m_Output << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    std::cerr << "Wrote " << m_WordCount << " candidates in " << m_Index.size() - 1 << " blocks of " << m_BlockSize;
+    std::cerr << ", skipped " << m_Duplicates << " duplicates and " << m_TooLong << " longer than " << WORDLIST_MAX_WORD << " bytes" << std::endl;
+    return true;
+}
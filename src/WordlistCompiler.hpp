@@ -0,0 +1,54 @@
+//
+//  WordlistCompiler.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef WordlistCompiler_hpp
+#define WordlistCompiler_hpp
+
+#include <filesystem>
+#include <stdio.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "CompiledWordlist.hpp"
+
+//
+// Converts a text wordlist into the CompiledWordlist format. Line
+// endings, empty lines, $HEX[] and duplicates are all dealt with
+// here once, rather than every time the wordlist is read.
+//
+class WordlistCompiler
+{
+public:
+    WordlistCompiler(void) = default;
+    void SetInput(const std::filesystem::path Input) { m_Input = Input; }
+    void SetOutput(const std::filesystem::path Output) { m_Output = Output; }
+    void SetBlockSize(const size_t BlockSize) { m_BlockSize = BlockSize; }
+    void SetParseHexInput(const bool ParseHexInput) { m_ParseHexInput = ParseHexInput; }
+    void SetDedup(const bool Dedup) { m_Dedup = Dedup; }
+    const std::filesystem::path GetOutput(void) const { return m_Output; }
+    const bool Compile(void);
+private:
+    const bool AddWord(const std::string& Word);
+    std::filesystem::path m_Input;
+    std::filesystem::path m_Output;
+    size_t m_BlockSize = 0;
+    bool m_ParseHexInput = false;
+    // Every candidate is held in memory to remove all duplicates
+    bool m_Dedup = false;
+    std::unordered_set<std::string> m_Seen;
+    std::string m_LastWord;
+    FILE* m_Handle = nullptr;
+    uint64_t m_Offset = 0;
+    std::vector<uint64_t> m_Index;
+    size_t m_WordCount = 0;
+    size_t m_Duplicates = 0;
+    size_t m_TooLong = 0;
+};
+
+#endif //WordlistCompiler_hpp
@@ -0,0 +1,250 @@
+//
+//  WorkStealingPool.hpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+#ifndef WorkStealingPool_hpp
+#define WorkStealingPool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Trace.hpp"
+
+//
+// Fixed set of worker threads, each with its own deque of tasks.
+// Tasks are pushed round robin, a worker that runs dry steals the
+// oldest task of another worker (preferring workers in its own
+// group) and parks once there is nothing left anywhere.
+//
+template<typename Task>
+class WorkStealingPool
+{
+public:
+    typedef std::function<void(const size_t Worker, Task& Item)> TaskHandler;
+    typedef std::function<void(const size_t Worker)> StartHandler;
+
+    WorkStealingPool(void) = default;
+    ~WorkStealingPool(void) { Cancel(); Wait(); };
+    void SetCapacity(const size_t Capacity) { m_Capacity = Capacity; }
+    void SetStartHandler(StartHandler Handler) { m_StartHandler = Handler; }
+    // Workers with the same group are stolen from first
+    void SetGroups(const std::vector<size_t> Groups) { m_Groups = Groups; }
+    void Start(const size_t Threads, TaskHandler Handler);
+    // Blocks while the pool is at capacity, false once cancelled
+    const bool Push(Task&& Item);
+    // No more tasks will be pushed, workers exit once drained
+    void Close(void);
+    // Workers exit after their current task, queued tasks are dropped
+    void Cancel(void);
+    void Wait(void);
+    const bool IsCancelled(void) const { return m_Cancelled; }
+    const size_t GetQueued(void) const { return std::max<int64_t>(m_Queued, 0); }
+private:
+    typedef struct _WorkerQueue
+    {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    } WorkerQueue;
+    const bool Take(WorkerQueue& Queue, Task& Item);
+    void Worker(const size_t Id);
+    TaskHandler m_Handler;
+    StartHandler m_StartHandler;
+    std::vector<size_t> m_Groups;
+    std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+    // Victims in the order each worker tries them
+    std::vector<std::vector<size_t>> m_Victims;
+    std::vector<std::thread> m_Threads;
+    size_t m_Capacity = 4096;
+    size_t m_Next = 0;
+    std::mutex m_ParkMutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_SpaceAvailable;
+    // Signed as a worker may take a task just before it is counted
+    std::atomic<int64_t> m_Queued = 0;
+    bool m_ProducerWaiting = false;
+    std::atomic<bool> m_Closed = false;
+    std::atomic<bool> m_Cancelled = false;
+};
+
+template<typename Task>
+void
+WorkStealingPool<Task>::Start(
+    const size_t Threads,
+    TaskHandler Handler
+)
+{
+    m_Handler = Handler;
+    m_Groups.resize(Threads, 0);
+
+    for (size_t i = 0; i < Threads; i++)
+    {
+        m_Queues.push_back(std::make_unique<WorkerQueue>());
+
+        std::vector<size_t> victims;
+        for (const bool local : {true, false})
+        {
+            for (size_t v = 1; v < Threads; v++)
+            {
+                const size_t victim = (i + v) % Threads;
+                if ((m_Groups[victim] == m_Groups[i]) == local)
+                {
+                    victims.push_back(victim);
+                }
+            }
+        }
+        m_Victims.push_back(std::move(victims));
+    }
+
+    for (size_t i = 0; i < Threads; i++)
+    {
+        m_Threads.emplace_back(&WorkStealingPool::Worker, this, i);
+    }
+}
+
+template<typename Task>
+const bool
+WorkStealingPool<Task>::Push(
+    Task&& Item
+)
+{
+    std::unique_lock<std::mutex> lock(m_ParkMutex);
+    if (m_Queued >= (int64_t)m_Capacity)
+    {
+        TRACE_SPAN("queue full");
+        m_ProducerWaiting = true;
+        m_SpaceAvailable.wait(lock, [&]{ return m_Queued < (int64_t)m_Capacity || m_Cancelled; });
+        m_ProducerWaiting = false;
+    }
+
+    if (m_Cancelled)
+    {
+        return false;
+    }
+
+    {
+        WorkerQueue& queue = *m_Queues[m_Next++ % m_Queues.size()];
+        std::lock_guard<std::mutex> queueLock(queue.Mutex);
+        queue.Tasks.push_back(std::move(Item));
+    }
+    m_Queued++;
+    lock.unlock();
+
+    m_WorkAvailable.notify_one();
+    return true;
+}
+
+template<typename Task>
+void
+WorkStealingPool<Task>::Close(
+    void
+)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_ParkMutex);
+        m_Closed = true;
+    }
+    m_WorkAvailable.notify_all();
+}
+
+template<typename Task>
+void
+WorkStealingPool<Task>::Cancel(
+    void
+)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_ParkMutex);
+        m_Cancelled = true;
+    }
+    m_WorkAvailable.notify_all();
+    m_SpaceAvailable.notify_all();
+}
+
+template<typename Task>
+void
+WorkStealingPool<Task>::Wait(
+    void
+)
+{
+    for (auto& thread : m_Threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+template<typename Task>
+const bool
+WorkStealingPool<Task>::Take(
+    WorkerQueue& Queue,
+    Task& Item
+)
+{
+    std::lock_guard<std::mutex> lock(Queue.Mutex);
+    if (Queue.Tasks.empty())
+    {
+        return false;
+    }
+    // Oldest first so input order is roughly kept
+    Item = std::move(Queue.Tasks.front());
+    Queue.Tasks.pop_front();
+    return true;
+}
+
+template<typename Task>
+void
+WorkStealingPool<Task>::Worker(
+    const size_t Id
+)
+{
+    if (m_StartHandler)
+    {
+        m_StartHandler(Id);
+    }
+
+    Task item;
+    while (!m_Cancelled)
+    {
+        bool found = Take(*m_Queues[Id], item);
+        for (size_t i = 0; !found && i < m_Victims[Id].size(); i++)
+        {
+            found = Take(*m_Queues[m_Victims[Id][i]], item);
+        }
+
+        if (found)
+        {
+            m_Queued--;
+            {
+                std::lock_guard<std::mutex> lock(m_ParkMutex);
+                if (m_ProducerWaiting)
+                {
+                    m_SpaceAvailable.notify_one();
+                }
+            }
+            m_Handler(Id, item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_ParkMutex);
+        if (m_Closed && m_Queued <= 0)
+        {
+            break;
+        }
+        TRACE_SPAN("park");
+        m_WorkAvailable.wait(lock, [&]{ return m_Cancelled || m_Closed || m_Queued > 0; });
+    }
+}
+
+#endif //WorkStealingPool_hpp
@@ -0,0 +1,33 @@
+//
+//  SimdKernel.cpp
+//  CrackList
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+//  Built once per ISA level together with the SimdHash sources. Every
+//  global symbol of each build is then given the level as a prefix,
+//  so these become avx2_SimdKernelHash and so on. CpuFeatures picks
+//  between them at runtime.
+//
+
+#include "simdhash.h"
+
+extern "C" size_t
+SimdKernelLanes(
+    void
+)
+{
+    return SimdLanes();
+}
+
+extern "C" void
+SimdKernelHash(
+    const HashAlgorithm Algorithm,
+    const size_t* Lengths,
+    const uint8_t** Buffers,
+    uint8_t* Digests
+)
+{
+    SimdHash(Algorithm, Lengths, Buffers, Digests);
+}
@@ -13,7 +13,11 @@
 #include <vector>
 
 #include "CrackList.hpp"
+#include "CrackServer.hpp"
+#include "DatasetGenerator.hpp"
+#include "HashListCompiler.hpp"
 #include "Util.hpp"
+#include "WordlistCompiler.hpp"
 #include "simdhash.h"
 
 #define ARGCHECK() \
@@ -23,6 +27,213 @@
         return 1; \
     }
 
+static int
+CompileMain(
+    int argc,
+    const char * argv[]
+)
+{
+    HashListCompiler compiler;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--out" || arg == "--outfile" || arg == "-o")
+        {
+            ARGCHECK();
+            compiler.SetOutput(argv[++i]);
+        }
+        else if (arg == "--sha1" || arg == "--ntlm" || arg == "--md5" || arg == "--md4")
+        {
+            auto algoStr = arg.substr(2);
+            auto algorithm = ParseHashAlgorithm(algoStr.c_str());
+            if (algorithm == HashAlgorithmUndefined)
+            {
+                std::cerr << "Unrecognised hash algorithm \"" << algoStr << "\"" << std::endl;
+                return 1;
+            }
+            compiler.SetAlgorithm(algorithm);
+        }
+        else if (arg == "--threads" || arg == "-t")
+        {
+            ARGCHECK();
+            compiler.SetThreads(atoi(argv[++i]));
+        }
+        else if (arg == "--memory" || arg == "-M")
+        {
+            ARGCHECK();
+            compiler.SetMemoryLimit(atoll(argv[++i]) * 1024 * 1024);
+        }
+        else if (arg == "--tmp")
+        {
+            ARGCHECK();
+            compiler.SetTempDirectory(argv[++i]);
+        }
+        else if (arg == "--index" || arg == "-i")
+        {
+            compiler.SetBuildIndex(true);
+        }
+        else if (arg == "--bitmask" || arg == "--masksize" || arg == "-m")
+        {
+            ARGCHECK();
+            compiler.SetBitmaskSize(atoi(argv[++i]));
+        }
+        else
+        {
+            compiler.AddInput(arg);
+        }
+    }
+
+    return compiler.Compile() ? 0 : 1;
+}
+
+static int
+CompileWordlistMain(
+    int argc,
+    const char * argv[]
+)
+{
+    WordlistCompiler compiler;
+    bool haveInput = false;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--out" || arg == "--outfile" || arg == "-o")
+        {
+            ARGCHECK();
+            compiler.SetOutput(argv[++i]);
+        }
+        else if (arg == "--blocksize")
+        {
+            ARGCHECK();
+            compiler.SetBlockSize(atoi(argv[++i]));
+        }
+        else if (arg == "--parse-hex" || arg == "-p")
+        {
+            compiler.SetParseHexInput(true);
+        }
+        else if (arg == "--dedup")
+        {
+            compiler.SetDedup(true);
+        }
+        else if (!haveInput)
+        {
+            compiler.SetInput(arg);
+            haveInput = true;
+        }
+        else
+        {
+            std::cerr << "Unrecognised argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    return compiler.Compile() ? 0 : 1;
+}
+
+static int
+GenerateMain(
+    int argc,
+    const char * argv[]
+)
+{
+    DatasetGenerator generator;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--out" || arg == "--outfile" || arg == "-o")
+        {
+            ARGCHECK();
+            generator.SetOutput(argv[++i]);
+        }
+        else if (arg == "--sha1" || arg == "--ntlm" || arg == "--md5" || arg == "--md4")
+        {
+            auto algoStr = arg.substr(2);
+            auto algorithm = ParseHashAlgorithm(algoStr.c_str());
+            if (algorithm == HashAlgorithmUndefined)
+            {
+                std::cerr << "Unrecognised hash algorithm \"" << algoStr << "\"" << std::endl;
+                return 1;
+            }
+            generator.SetAlgorithm(algorithm);
+        }
+        else if (arg == "--seed")
+        {
+            ARGCHECK();
+            generator.SetSeed(strtoull(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--targets")
+        {
+            ARGCHECK();
+            generator.SetTargets(atoll(argv[++i]));
+        }
+        else if (arg == "--words")
+        {
+            ARGCHECK();
+            generator.SetWords(atoll(argv[++i]));
+        }
+        else if (arg == "--hits")
+        {
+            ARGCHECK();
+            generator.SetHits(atoll(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "Unrecognised argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    return generator.Generate() ? 0 : 1;
+}
+
+static int
+SubmitMain(
+    int argc,
+    const char * argv[]
+)
+{
+    std::string socketPath;
+    std::string wordlist;
+    std::string outfile;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--out" || arg == "--outfile" || arg == "-o")
+        {
+            ARGCHECK();
+            outfile = argv[++i];
+        }
+        else if (socketPath == "")
+        {
+            socketPath = arg;
+        }
+        else if (wordlist == "")
+        {
+            wordlist = arg;
+        }
+        else
+        {
+            std::cerr << "Unrecognised positional argument: " << argv[i] << std::endl;
+        }
+    }
+
+    if (socketPath == "")
+    {
+        std::cerr << "Usage: " << argv[0] << " submit socket [wordlist] [-o outfile]" << std::endl;
+        return 1;
+    }
+
+    return CrackServer::Submit(socketPath, wordlist, outfile) ? 0 : 1;
+}
+
 int main(
 	int argc,
 	const char * argv[]
@@ -31,10 +242,35 @@ int main(
     if (argc < 2)
     {
         std::cerr << "Usage: " << argv[0] << " hashfile wordlist" << std::endl;
+        std::cerr << "       " << argv[0] << " compile [--memory MB] [--index] -o hashes.bin inputs..." << std::endl;
+        std::cerr << "       " << argv[0] << " compile-wordlist [--blocksize N] [--parse-hex] [--dedup] -o words.clw wordlist" << std::endl;
+        std::cerr << "       " << argv[0] << " --serve socket hashfile" << std::endl;
+        std::cerr << "       " << argv[0] << " --shm-unlink name" << std::endl;
+        std::cerr << "       " << argv[0] << " submit socket [wordlist] [-o outfile]" << std::endl;
+        std::cerr << "       " << argv[0] << " generate [--seed N] [--targets N] [--words N] [--hits N] -o directory" << std::endl;
         return 0;
     }
 
+    if (std::string(argv[1]) == "compile")
+    {
+        return CompileMain(argc, argv);
+    }
+    else if (std::string(argv[1]) == "compile-wordlist")
+    {
+        return CompileWordlistMain(argc, argv);
+    }
+    else if (std::string(argv[1]) == "generate")
+    {
+        return GenerateMain(argc, argv);
+    }
+    else if (std::string(argv[1]) == "submit")
+    {
+        return SubmitMain(argc, argv);
+    }
+
     CrackList cracklist;
+    std::string serveSocket;
+    bool benchmark = false;
 
     for (int i = 1; i < argc; i++)
     {
@@ -79,6 +315,121 @@ int main(
             ARGCHECK();
             cracklist.SetBitmaskSize(atoi(argv[++i]));
         }
+        else if (arg == "--compressed" || arg == "-z")
+        {
+            cracklist.SetCompressed(true);
+        }
+        else if (arg == "--serve")
+        {
+            ARGCHECK();
+            serveSocket = argv[++i];
+        }
+        else if (arg == "--shm")
+        {
+            ARGCHECK();
+            cracklist.SetSharedName(argv[++i]);
+        }
+        else if (arg == "--shm-unlink")
+        {
+            ARGCHECK();
+            return HashList::UnlinkShared(argv[++i]) ? 0 : 1;
+        }
+        else if (arg == "--checkpoint")
+        {
+            ARGCHECK();
+            cracklist.SetCheckpointFile(argv[++i]);
+        }
+        else if (arg == "--checkpoint-interval")
+        {
+            ARGCHECK();
+            cracklist.SetCheckpointInterval(atoi(argv[++i]));
+        }
+        else if (arg == "--restore")
+        {
+            ARGCHECK();
+            cracklist.SetCheckpointFile(argv[++i]);
+            cracklist.SetRestore(true);
+        }
+        else if (arg == "--skip")
+        {
+            ARGCHECK();
+            cracklist.SetSkip(strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--limit")
+        {
+            ARGCHECK();
+            cracklist.SetLimit(strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--slice")
+        {
+            ARGCHECK();
+            std::string slice = argv[++i];
+            const size_t separator = slice.find('/');
+            if (separator == std::string::npos)
+            {
+                std::cerr << "Slice must be of the form K/N" << std::endl;
+                return 1;
+            }
+            cracklist.SetSlice(atoi(slice.substr(0, separator).c_str()), atoi(slice.substr(separator + 1).c_str()));
+        }
+        else if (arg == "--numa")
+        {
+            cracklist.SetNuma(true);
+        }
+        else if (arg == "--hugepages")
+        {
+            cracklist.SetHugePages(true);
+        }
+        else if (arg == "--tlb-stats")
+        {
+            cracklist.SetTlbStats(true);
+        }
+        else if (arg == "--dedup")
+        {
+            ARGCHECK();
+            cracklist.SetDedupBytes(atoll(argv[++i]) * 1024 * 1024);
+        }
+        else if (arg == "--status-json")
+        {
+            ARGCHECK();
+            cracklist.SetStatusJson(argv[++i]);
+        }
+        else if (arg == "--status-interval")
+        {
+            ARGCHECK();
+            cracklist.SetStatusInterval(atoi(argv[++i]));
+        }
+        else if (arg == "--watch")
+        {
+            cracklist.SetWatch(true);
+        }
+        else if (arg == "--eager-index")
+        {
+            cracklist.SetLazyIndex(false);
+        }
+        else if (arg == "--benchmark")
+        {
+            benchmark = true;
+        }
+        else if (arg == "--trace")
+        {
+            ARGCHECK();
+            cracklist.SetTraceFile(argv[++i]);
+        }
+        else if (arg == "--left")
+        {
+            ARGCHECK();
+            cracklist.SetLeftFile(argv[++i]);
+        }
+        else if (arg == "--sort-merge" || arg == "--merge")
+        {
+            cracklist.SetSortMerge(true);
+        }
+        else if (arg == "--merge-batch")
+        {
+            ARGCHECK();
+            cracklist.SetMergeBatchSize(std::min<size_t>(atoll(argv[++i]), UINT32_MAX));
+        }
         else if (arg == "--autohex" || arg == "-a")
         {
             cracklist.SetAutohex(true);
@@ -118,6 +469,18 @@ int main(
         }
     }
 
+    if (benchmark)
+    {
+        return cracklist.Benchmark() ? 0 : 1;
+    }
+
+    if (serveSocket != "")
+    {
+        CrackServer server(cracklist);
+        server.SetSocketPath(serveSocket);
+        return server.Serve() ? 0 : 1;
+    }
+
     cracklist.Crack();
 
     return 0;